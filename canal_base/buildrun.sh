@@ -7,6 +7,8 @@ VERBOSE=false
 CLEAN_BUILD=false
 SINGLETHREAD=false
 REFINE_MESH=false
+# Número de processos escolhido pelo generate_cfd (mesmo numberOfSubdomains do decomposeParDict)
+NP=${number_of_subdomains}
 
 for arg in "$@"; do
   [ "$arg" = "--verbose" ] && VERBOSE=true
@@ -15,15 +17,24 @@ for arg in "$@"; do
   [ "$arg" = "--refineMesh" ] && REFINE_MESH=true
 done
 
+# Malha pequena: um subdomínio só, roda sem MPI
+[ "$NP" -le 1 ] && SINGLETHREAD=true
+
 # Run clean if requested
 if [ "$CLEAN_BUILD" = true ]; then
   foamCleanCase 2>&1 | tee logs/foamCleanCase.log
   mkdir -p logs
 fi
 
+# generate_cfd --writePolyMesh já escreve constant/polyMesh (com a ignitionZone)
+MESH_WRITTEN=false
+[ -f constant/polyMesh/owner ] && MESH_WRITTEN=true
+
 if [ "$VERBOSE" = true ]; then
-  blockMesh 2>&1 | tee logs/blockMesh.log
-  createZones 2>&1 | tee logs/createZones.log
+  if [ "$MESH_WRITTEN" = false ]; then
+    blockMesh 2>&1 | tee logs/blockMesh.log
+    createZones 2>&1 | tee logs/createZones.log
+  fi
   if [ "$REFINE_MESH" = true ]; then
     refineMesh -all 2>&1 | tee logs/refineMesh.log
   fi
@@ -40,14 +51,18 @@ if [ "$VERBOSE" = true ]; then
     foamRun 2>&1 | tee logs/foamRun.log
   else
     decomposePar -force 2>&1 | tee logs/decomposePar.log
-    mpirun -np 4 --oversubscribe foamRun -parallel 2>&1 | tee logs/foamRun.log || true
+    mpirun -np "$NP" foamRun -parallel 2>&1 | tee logs/foamRun.log || true
     reconstructPar 2>&1 | tee logs/reconstructPar.log
   fi
 else
-  echo "Running blockMesh..."
-  blockMesh 2>&1 >> logs/blockMesh.log
-  echo "Running createZones..."
-  createZones 2>&1 >> logs/createZones.log
+  if [ "$MESH_WRITTEN" = false ]; then
+    echo "Running blockMesh..."
+    blockMesh 2>&1 >> logs/blockMesh.log
+    echo "Running createZones..."
+    createZones 2>&1 >> logs/createZones.log
+  else
+    echo "Using constant/polyMesh written by generate_cfd"
+  fi
   if [ "$REFINE_MESH" = true ]; then
     echo "Running refineMesh..."
     refineMesh -all 2>&1 >> logs/refineMesh.log
@@ -69,7 +84,7 @@ else
     echo "Running decomposePar..."
     decomposePar -force 2>&1 >> logs/decomposePar.log
     echo "Running foamRun (mpirun)..."
-    mpirun -np 4 --oversubscribe foamRun -parallel 2>&1 >> logs/foamRun.log || true
+    mpirun -np "$NP" foamRun -parallel 2>&1 >> logs/foamRun.log || true
     echo "Running reconstructPar..."
     reconstructPar 2>&1 >> logs/reconstructPar.log
   fi
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/Solution.h"
+#include "cantera/onedim.h"
+#include "lib.h"
+
+// Benchmark velocidade x precisão de mecanismos (completo, reduzido, tiers do mechanism_tier).
+//
+// Uso: benchmark_mechanisms [--output output] [--sweep 0:0.2:0.005] [mecanismo.yaml ...]
+//      (padrão: gri30.yaml output/modified_mechanism.yaml; o primeiro é a referência)
+//
+// Cada mecanismo roda a mesma varredura de fração de mistura do main (CH4/ar, 300 K, 1 bar),
+// medindo tempo de parede, tamanho da malha e avaliações do Newton. Os erros de S_L, Tad e Tmax são
+// relativos à referência, só nos pontos em que as duas chamas convergiram. Escreve
+// <output>/mechanism_benchmark.csv (por ponto) e <output>/mechanism_pareto.csv (por mecanismo,
+// com a fronteira de Pareto entre tempo por chama convergida e erro máximo de S_L). Um mecanismo
+// que converge em menos pontos que a referência fica fora da fronteira: seu erro só cobre os pontos
+// fáceis e seu tempo não inclui as chamas que ele não consegue resolver.
+
+struct sweep_point {
+  double mixture_fraction;
+  thermo_state state;
+  flame_solve_stats stats;
+  double wall_time;  // s
+};
+
+struct mechanism_cost {
+  std::string name;
+  size_t n_species;
+  size_t n_reactions;
+  double wall_time;        // s, varredura inteira
+  double time_per_flame;   // s, wall_time / chamas convergidas
+  double grid_points;      // Média por chama convergida
+  long function_evaluations;
+  long jacobian_evaluations;
+  size_t converged;
+  double mean_error[3];    // S_L, Tad, Tmax
+  double max_error[3];
+  bool pareto;
+};
+
+int main(int argc, char** argv) {
+  std::string output_dir = "output";
+  double sweep_min = 0.0, sweep_max = 0.20, sweep_step = 0.005;
+  std::vector<std::string> mechanisms;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 < argc && arg == "--output") {
+      output_dir = argv[++i];
+    } else if (i + 1 < argc && arg == "--sweep") {
+      std::string spec = argv[++i];
+      auto first       = spec.find(':');
+      auto second      = spec.find(':', first + 1);
+      sweep_min        = std::stod(spec.substr(0, first));
+      sweep_max        = std::stod(spec.substr(first + 1, second - first - 1));
+      sweep_step       = std::stod(spec.substr(second + 1));
+    } else if (arg.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    } else {
+      mechanisms.push_back(arg);
+    }
+  }
+  if (mechanisms.empty()) {
+    mechanisms = {"gri30.yaml", output_dir + "/modified_mechanism.yaml"};
+  }
+  std::filesystem::create_directories(output_dir);
+
+  // Mesma chama do main.cpp
+  int loglevel       = 0;
+  bool refine_grid   = true;
+  auto fuel          = "CH4";
+  auto oxidizer      = "O2:1, N2:3.76";
+  double temperature = 300.0;                  // K
+  double pressure    = 1.0 * Cantera::OneBar;  // Bar
+  double uin         = 0.3;                    // m/sec
+
+  std::vector<double> sweep;
+  for (auto mixture_fraction = sweep_min; mixture_fraction <= sweep_max + 1e-12;
+       mixture_fraction += sweep_step) {
+    sweep.push_back(mixture_fraction);
+  }
+
+  std::ofstream points_out(output_dir + "/mechanism_benchmark.csv", std::ios::trunc);
+  points_out << "mechanism,mixture_fraction,flamespeed,Tad,Tmax,wall_time,grid_points,"
+                "function_evaluations,jacobian_evaluations\n";
+
+  std::vector<std::vector<sweep_point>> results;
+  std::vector<mechanism_cost> costs;
+  for (const auto& mechanism : mechanisms) {
+    mechanism_cost cost{std::filesystem::path(mechanism).stem().string(), 0, 0, 0.0, 0.0, 0.0, 0, 0, 0,
+                        {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, false};
+    std::vector<sweep_point> points;
+    try {
+      auto sol         = Cantera::newSolution(mechanism, "gri30", "mixture-averaged");
+      cost.n_species   = sol->thermo()->nSpecies();
+      cost.n_reactions = sol->kinetics()->nReactions();
+
+      for (auto mixture_fraction : sweep) {
+        std::multimap<std::string, std::pair<std::string, double>> reactions;
+        sweep_point point{mixture_fraction, {}, {}, 0.0};
+        auto start = std::chrono::steady_clock::now();
+        try {
+          point.state = flamespeed(sol,
+                                   temperature,
+                                   pressure,
+                                   uin,
+                                   mixture_fraction,
+                                   fuel,
+                                   oxidizer,
+                                   refine_grid,
+                                   loglevel,
+                                   reactions,
+                                   nullptr,
+                                   &point.stats);
+        } catch (Cantera::CanteraError& err) {
+          std::cout << err.what() << std::endl;
+        }
+        point.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                              .count();
+
+        cost.wall_time += point.wall_time;
+        cost.function_evaluations += point.stats.function_evaluations;
+        cost.jacobian_evaluations += point.stats.jacobian_evaluations;
+        if (point.state.flamespeed > 0.0) {
+          cost.converged++;
+          cost.grid_points += static_cast<double>(point.stats.grid_points);
+        }
+        points_out << cost.name << "," << mixture_fraction << "," << point.state.flamespeed << ","
+                   << point.state.Tad << "," << point.state.Tmax << "," << point.wall_time << ","
+                   << point.stats.grid_points << "," << point.stats.function_evaluations << ","
+                   << point.stats.jacobian_evaluations << "\n";
+        points.push_back(point);
+      }
+    } catch (std::exception& err) {
+      std::cerr << cost.name << ": " << err.what() << std::endl;
+    }
+    cost.grid_points /= std::max<size_t>(cost.converged, 1);
+    cost.time_per_flame = cost.converged > 0 ? cost.wall_time / cost.converged
+                                             : std::numeric_limits<double>::infinity();
+    std::cout << cost.name << ": " << cost.n_reactions << " reações, " << cost.wall_time
+              << " s, " << cost.converged << "/" << sweep.size() << " chamas" << std::endl;
+    results.push_back(points);
+    costs.push_back(cost);
+  }
+
+  // Erros em relação ao primeiro mecanismo
+  const auto& reference = results.front();
+  for (size_t m = 0; m < costs.size(); m++) {
+    size_t compared = 0;
+    for (size_t p = 0; p < results[m].size() && p < reference.size(); p++) {
+      const auto& a = results[m][p].state;
+      const auto& b = reference[p].state;
+      if (a.flamespeed <= 0.0 || b.flamespeed <= 0.0) {
+        continue;
+      }
+      double errors[3] = {std::abs(a.flamespeed - b.flamespeed) / b.flamespeed,
+                          std::abs(a.Tad - b.Tad) / b.Tad, std::abs(a.Tmax - b.Tmax) / b.Tmax};
+      for (int q = 0; q < 3; q++) {
+        costs[m].mean_error[q] += errors[q];
+        costs[m].max_error[q] = std::max(costs[m].max_error[q], errors[q]);
+      }
+      compared++;
+    }
+    for (int q = 0; q < 3; q++) {
+      costs[m].mean_error[q] /= std::max<size_t>(compared, 1);
+    }
+  }
+
+  // Pareto: nenhum outro mecanismo é ao mesmo tempo mais rápido por chama e mais preciso (erro
+  // máximo de S_L). Só concorrem os que convergem em pelo menos tantos pontos quanto a referência.
+  auto complete = [&](const mechanism_cost& cost) {
+    return cost.converged >= costs.front().converged;
+  };
+  for (auto& a : costs) {
+    a.pareto = complete(a) && std::none_of(costs.begin(), costs.end(), [&](const mechanism_cost& b) {
+      return complete(b) && b.time_per_flame <= a.time_per_flame &&
+             b.max_error[0] <= a.max_error[0] &&
+             (b.time_per_flame < a.time_per_flame || b.max_error[0] < a.max_error[0]);
+    });
+  }
+
+  std::ofstream pareto_out(output_dir + "/mechanism_pareto.csv", std::ios::trunc);
+  pareto_out << "mechanism,n_species,n_reactions,wall_time,time_per_flame,speedup,grid_points,"
+                "function_evaluations,jacobian_evaluations,converged,"
+                "flamespeed_error_mean,flamespeed_error_max,Tad_error_mean,Tad_error_max,"
+                "Tmax_error_mean,Tmax_error_max,pareto\n";
+  for (const auto& cost : costs) {
+    // Razão dos tempos por chama convergida
+    double speedup = cost.converged > 0 && costs.front().converged > 0
+                         ? costs.front().time_per_flame / cost.time_per_flame
+                         : 0.0;
+    pareto_out << cost.name << "," << cost.n_species << "," << cost.n_reactions << ","
+               << cost.wall_time << "," << cost.time_per_flame << "," << speedup << ","
+               << cost.grid_points << ","
+               << cost.function_evaluations << "," << cost.jacobian_evaluations << ","
+               << cost.converged;
+    for (int q = 0; q < 3; q++) {
+      pareto_out << "," << cost.mean_error[q] << "," << cost.max_error[q];
+    }
+    pareto_out << "," << cost.pareto << "\n";
+    std::cout << cost.name << ": speedup " << speedup << "x, erro de S_L médio "
+              << cost.mean_error[0] << ", máximo " << cost.max_error[0]
+              << (cost.pareto ? " (Pareto)" : "")
+              << (complete(cost) ? "" : " (fora do Pareto: menos chamas convergidas)") << std::endl;
+  }
+  return 0;
+}
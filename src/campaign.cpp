@@ -0,0 +1,544 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/Solution.h"
+#include "cantera/onedim.h"
+#include "flame_table.h"
+#include "lib.h"
+#include "work_queue.h"
+
+// Campanha de chamas distribuída entre processos por uma fila em diretório compartilhado
+// (work_queue.h). Cada processo isola as falhas do Cantera: se um worker morre, as tarefas dele
+// voltam para a fila (até --attempts tentativas) e o resto da campanha continua.
+//
+// Uso: campaign run    --queue dir [--local N] [opções da campanha]   (submit + N workers + merge)
+//      campaign submit --queue dir [opções da campanha]
+//      campaign worker --queue dir
+//      campaign merge  --queue dir
+//      campaign status --queue dir
+//
+// Opções da campanha (gravadas em <queue>/campaign; os workers e o merge leem de lá):
+//   --campaign sweep|table  sweep: varredura em fração de mistura do main (completo x reduzido),
+//                           uma tarefa por ponto -> <output>/flame_speed_data.csv
+//                           table: tabela do generate_table, uma tarefa por linha (T, p) em phi
+//                           -> <output>/flame_table.bin e <output>/laminarFlameSpeedTable
+//   --mechanism gri30.yaml  --reduced output/modified_mechanism.yaml  --output output
+//   --sweep 0:0.2:0.005     --phi 0.6:1.4:9  --T 300:600:4  --p 1:5:3 (bar)
+//
+// Opções de execução: --local N (workers locais do run), --attempts 3, --timeout 300 (s sem
+// heartbeat até a tarefa voltar para a fila), --heartbeat 10 (s), --poll 2 (s).
+//
+// Num cluster: `campaign submit` uma vez, `campaign worker` em cada nó (srun, mpirun, ssh...), e
+// `campaign merge` no fim. Em uma máquina: `campaign run --local 8`.
+
+using manifest = std::map<std::string, std::string>;
+
+struct campaign_options {
+  std::string command;
+  std::filesystem::path queue;
+  manifest campaign = {{"campaign", "sweep"},
+                       {"mechanism", "gri30.yaml"},
+                       {"reduced", "output/modified_mechanism.yaml"},
+                       {"output", "output"},
+                       {"sweep", "0:0.2:0.005"},
+                       {"phi", "0.6:1.4:9"},
+                       {"T", "300:600:4"},
+                       {"p", "1:5:3"}};
+  unsigned local     = 0;
+  int attempts       = 3;
+  int timeout        = 300;  // s
+  double heartbeat   = 10.0;  // s
+  double poll        = 2.0;   // s
+};
+
+// Mesma chama do main.cpp e do generate_table.cpp
+const int loglevel       = 0;
+const bool refine_grid   = true;
+const char* fuel         = "CH4";
+const char* oxidizer     = "O2:1, N2:3.76";
+const double temperature = 300.0;  // K
+const double uin         = 0.3;    // m/s
+
+std::string format(double value) {
+  std::ostringstream text;
+  text.precision(17);
+  text << value;
+  return text.str();
+}
+
+// std::stod em vez de operator>>, que não lê "nan" (pontos inválidos da tabela)
+std::vector<double> parse_numbers(const std::string& text) {
+  std::istringstream in(text);
+  std::vector<double> values;
+  for (std::string token; in >> token;) {
+    values.push_back(std::stod(token));
+  }
+  return values;
+}
+
+manifest read_manifest(const std::filesystem::path& path) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    throw std::runtime_error("campanha não encontrada: " + path.string() + " (rode submit antes)");
+  }
+  manifest values;
+  std::string key, value;
+  while (in >> key && std::getline(in >> std::ws, value)) {
+    values[key] = value;
+  }
+  return values;
+}
+
+void write_manifest(const std::filesystem::path& path, const manifest& values) {
+  std::ofstream out(path, std::ios::trunc);
+  for (const auto& [key, value] : values) {
+    out << key << " " << value << "\n";
+  }
+}
+
+std::vector<double> pressures(const manifest& campaign) {
+  auto p = parse_axis(campaign.at("p"));
+  for (auto& value : p) {
+    value *= Cantera::OneBar;
+  }
+  return p;
+}
+
+// Tarefas (nome, especificação) da campanha; a ordem dos nomes é a ordem em que saem da fila
+std::vector<std::pair<std::string, std::string>> campaign_tasks(const manifest& campaign) {
+  std::vector<std::pair<std::string, std::string>> tasks;
+  auto task_name = [](const std::string& prefix, size_t index) {
+    std::string number = std::to_string(index);
+    return prefix + std::string(number.size() < 4 ? 4 - number.size() : 0, '0') + number;
+  };
+
+  if (campaign.at("campaign") == "sweep") {
+    // Mesma acumulação do laço do main, para reproduzir os mesmos pontos
+    auto spec         = campaign.at("sweep");
+    auto first        = spec.find(':');
+    auto second       = spec.find(':', first + 1);
+    double sweep_min  = std::stod(spec.substr(0, first));
+    double sweep_max  = std::stod(spec.substr(first + 1, second - first - 1));
+    double sweep_step = std::stod(spec.substr(second + 1));
+    size_t index      = 0;
+    for (auto mixture_fraction = sweep_min; mixture_fraction <= sweep_max;
+         mixture_fraction += sweep_step) {
+      tasks.push_back({task_name("sweep_", index++), "sweep " + format(mixture_fraction)});
+    }
+    tasks.push_back({"sweep_stoichiometric", "sweep " + campaign.at("stoichiometric")});
+  } else {
+    size_t n_T = parse_axis(campaign.at("T")).size();
+    size_t n_p = parse_axis(campaign.at("p")).size();
+    for (size_t line = 0; line < n_T * n_p; line++) {
+      tasks.push_back({task_name("table_", line),
+                       "table " + std::to_string(line / n_p) + " " + std::to_string(line % n_p)});
+    }
+  }
+  return tasks;
+}
+
+// ===== Tarefas =====
+
+// S_L, Tad, Tmax e z_max do reduzido e do completo, como uma iteração do laço do main
+std::string run_sweep_task(const manifest& campaign, double mixture_fraction) {
+  std::ostringstream result;
+  result.precision(17);
+  for (const auto& mechanism : {campaign.at("reduced"), campaign.at("mechanism")}) {
+    auto sol           = Cantera::newSolution(mechanism, "gri30", "mixture-averaged");
+    thermo_state state = {0.0, 0.0, 0.0, 0.0};
+    try {
+      state = flamespeed(sol,
+                         temperature,
+                         Cantera::OneBar,
+                         uin,
+                         mixture_fraction,
+                         fuel,
+                         oxidizer,
+                         refine_grid,
+                         loglevel);
+    } catch (Cantera::CanteraError& err) {
+      std::cout << err.what() << std::endl;
+      state = {0.0, 0.0, 0.0, 0.0};
+    }
+    result << state.flamespeed << " " << state.Tad << " " << state.Tmax << " " << state.zmax << " ";
+  }
+  return result.str();
+}
+
+// Uma linha (T, p) da tabela: ponto mais próximo da estequiometria e, a partir dele, os dois lados
+// do eixo phi reaproveitando a solução vizinha (etapa 3 do generate_table)
+std::string run_table_task(const manifest& campaign, size_t i_T, size_t i_p) {
+  auto phi_axis = parse_axis(campaign.at("phi"));
+  auto T_axis   = parse_axis(campaign.at("T"));
+  auto p_axis   = pressures(campaign);
+  auto sol      = Cantera::newSolution(campaign.at("mechanism"), "", "mixture-averaged");
+
+  std::vector<double> mixture_fraction(phi_axis.size());
+  size_t i_center = 0;
+  for (size_t i = 0; i < phi_axis.size(); i++) {
+    sol->thermo()->setEquivalenceRatio(phi_axis[i], fuel, oxidizer);
+    mixture_fraction[i] = sol->thermo()->mixtureFraction(fuel, oxidizer);
+    if (std::abs(phi_axis[i] - 1.0) < std::abs(phi_axis[i_center] - 1.0)) {
+      i_center = i;
+    }
+  }
+
+  // Chama que não convergiu fica inválida (NaN), como no generate_table
+  std::vector<flame_table_entry> line(phi_axis.size(), flame_table_entry::invalid());
+  auto solve = [&](size_t i_phi, flame_profile& profile) {
+    thermo_state state;
+    try {
+      state = flamespeed(sol,
+                         T_axis[i_T],
+                         p_axis[i_p],
+                         uin,
+                         mixture_fraction[i_phi],
+                         fuel,
+                         oxidizer,
+                         refine_grid,
+                         loglevel,
+                         empty_reactions,
+                         &profile);
+    } catch (Cantera::CanteraError& err) {
+      std::cout << err.what() << std::endl;
+    }
+    flame_table_entry entry{state.flamespeed, state.Tad, state.Tmax, state.thickness};
+    line[i_phi] = entry.valid() ? entry : flame_table_entry::invalid();
+  };
+
+  flame_profile center;
+  solve(i_center, center);
+  auto profile = center;
+  for (size_t i_phi = i_center + 1; i_phi < phi_axis.size(); i_phi++) {
+    solve(i_phi, profile);
+  }
+  profile = center;
+  for (size_t i_phi = i_center; i_phi-- > 0;) {
+    solve(i_phi, profile);
+  }
+
+  std::ostringstream result;
+  result.precision(17);
+  for (const auto& entry : line) {
+    result << entry.flamespeed << " " << entry.Tad << " " << entry.Tmax << " " << entry.thickness
+           << " ";
+  }
+  return result.str();
+}
+
+std::string run_task(const manifest& campaign, const std::string& spec) {
+  std::istringstream in(spec);
+  std::string kind;
+  in >> kind;
+  if (kind == "sweep") {
+    double mixture_fraction;
+    in >> mixture_fraction;
+    return run_sweep_task(campaign, mixture_fraction);
+  }
+  if (kind == "table") {
+    size_t i_T, i_p;
+    in >> i_T >> i_p;
+    return run_table_task(campaign, i_T, i_p);
+  }
+  throw std::runtime_error("tarefa desconhecida: " + spec);
+}
+
+// ===== Comandos =====
+
+int submit(const campaign_options& options) {
+  work_queue queue(options.queue);
+  auto path = options.queue / "campaign";
+  manifest campaign;
+  if (std::filesystem::exists(path)) {
+    campaign = read_manifest(path);
+    std::cout << "Retomando a campanha em " << options.queue << std::endl;
+  } else {
+    campaign = options.campaign;
+    if (campaign.at("campaign") != "sweep" && campaign.at("campaign") != "table") {
+      std::cerr << "Erro: --campaign deve ser sweep ou table" << std::endl;
+      return 1;
+    }
+    // Caminhos absolutos: os workers podem rodar em outro diretório (ou nó)
+    for (auto key : {"mechanism", "reduced", "output"}) {
+      if (std::filesystem::exists(campaign[key]) || key == std::string("output")) {
+        campaign[key] = std::filesystem::absolute(campaign[key]).string();
+      }
+    }
+    auto gas = Cantera::newSolution(campaign.at("mechanism"), "", "mixture-averaged")->thermo();
+    gas->setEquivalenceRatio(1.0, fuel, oxidizer);
+    campaign["stoichiometric"] = format(gas->mixtureFraction(fuel, oxidizer));
+    write_manifest(path, campaign);
+  }
+
+  size_t submitted = 0;
+  auto tasks       = campaign_tasks(campaign);
+  for (const auto& [name, spec] : tasks) {
+    submitted += queue.submit(name, spec);
+  }
+  std::cout << submitted << " de " << tasks.size() << " tarefas enfileiradas (" << queue.done()
+            << " já concluídas)" << std::endl;
+  return 0;
+}
+
+int worker(const campaign_options& options) {
+  work_queue queue(options.queue);
+  queue.max_attempts = options.attempts;
+  auto campaign      = read_manifest(options.queue / "campaign");
+  auto id            = work_queue::worker_id();
+
+  while (true) {
+    auto task = queue.claim(id);
+    if (!task) {
+      if (queue.finished()) {
+        return 0;
+      }
+      queue.requeue_stale(std::chrono::seconds(options.timeout));
+      std::this_thread::sleep_for(std::chrono::duration<double>(options.poll));
+      continue;
+    }
+    std::cout << "[" << id << "] " << task->name << " (" << task->spec << ", tentativa "
+              << task->attempt + 1 << ")" << std::endl;
+
+    // Heartbeat enquanto a chama é resolvida, para os outros processos saberem que está viva
+    std::atomic<bool> busy{true};
+    std::thread heartbeat([&]() {
+      auto last = std::chrono::steady_clock::now();
+      while (busy) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        if (std::chrono::steady_clock::now() - last > std::chrono::duration<double>(options.heartbeat)) {
+          work_queue::heartbeat(task->running);
+          last = std::chrono::steady_clock::now();
+        }
+      }
+    });
+    try {
+      auto result = run_task(campaign, task->spec);
+      busy        = false;
+      heartbeat.join();
+      queue.complete(*task, result);
+    } catch (std::exception& err) {
+      busy = false;
+      heartbeat.join();
+      std::cerr << "[" << id << "] " << task->name << ": " << err.what() << std::endl;
+      queue.requeue_worker(id);
+    }
+  }
+}
+
+int merge(const campaign_options& options) {
+  work_queue queue(options.queue);
+  auto campaign = read_manifest(options.queue / "campaign");
+  auto results  = queue.results();
+  auto output   = std::filesystem::path(campaign.at("output"));
+  std::filesystem::create_directories(output);
+
+  size_t missing = 0;
+  auto lookup    = [&](const std::string& name, size_t count, double fill) {
+    auto it     = results.find(name);
+    auto values = it != results.end() ? parse_numbers(it->second) : std::vector<double>{};
+    if (values.size() != count) {
+      std::cerr << "Aviso: " << name << " sem resultado (valores " << fill << ")" << std::endl;
+      missing++;
+      values.assign(count, fill);
+    }
+    return values;
+  };
+
+  if (campaign.at("campaign") == "sweep") {
+    std::vector<::output> rows;
+    for (const auto& [name, spec] : campaign_tasks(campaign)) {
+      auto v = lookup(name, 8, 0.0);
+      rows.push_back({parse_numbers(spec.substr(spec.find(' '))).front(),
+                      v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]});
+    }
+    auto num_reactions_reduced =
+        Cantera::newSolution(campaign.at("reduced"), "gri30", "mixture-averaged")
+            ->kinetics()
+            ->nReactions();
+    write_flame_speed_data((output / "flame_speed_data.csv").string(),
+                           rows,
+                           std::stod(campaign.at("stoichiometric")),
+                           num_reactions_reduced);
+    std::cout << "Data written to " << (output / "flame_speed_data.csv").string() << std::endl;
+  } else {
+    flame_table table(parse_axis(campaign.at("phi")), parse_axis(campaign.at("T")), pressures(campaign));
+    for (const auto& [name, spec] : campaign_tasks(campaign)) {
+      auto index = parse_numbers(spec.substr(spec.find(' ')));
+      auto v     = lookup(name, table.phi.size() * flame_table::n_fields,
+                          std::numeric_limits<double>::quiet_NaN());
+      for (size_t i_phi = 0; i_phi < table.phi.size(); i_phi++) {
+        const double* entry = &v[i_phi * flame_table::n_fields];
+        table.set(i_phi, static_cast<size_t>(index[0]), static_cast<size_t>(index[1]),
+                  {entry[0], entry[1], entry[2], entry[3]});
+      }
+    }
+    table.write((output / "flame_table.bin").string());
+    table.writeFoamDictionary((output / "laminarFlameSpeedTable").string());
+    std::cout << "Table written to " << output.string() << "/flame_table.bin and "
+              << output.string() << "/laminarFlameSpeedTable" << std::endl;
+
+    auto failed = table.invalid_points();
+    for (const auto& [i_phi, i_T, i_p] : failed) {
+      std::cerr << "Aviso: ponto inválido na tabela em phi = " << table.phi[i_phi]
+                << ", T = " << table.T[i_T] << " K, p = " << table.p[i_p] / Cantera::OneBar
+                << " bar" << std::endl;
+    }
+    if (!failed.empty()) {
+      std::cerr << failed.size() << " de " << table.data.size() / flame_table::n_fields
+                << " pontos sem chama convergida" << std::endl;
+      missing++;
+    }
+  }
+  return missing > 0 ? 2 : 0;
+}
+
+int status(const campaign_options& options) {
+  work_queue queue(options.queue);
+  std::cout << "pending " << queue.pending() << ", running " << queue.running() << ", done "
+            << queue.done() << ", failed " << queue.failed() << std::endl;
+  for (const auto& [name, spec] : queue.failures()) {
+    std::cout << "  failed: " << name << " (" << spec << ")" << std::endl;
+  }
+  return 0;
+}
+
+// submit, N workers locais (processos filhos) e merge. Um worker que morre (sinal ou saída != 0)
+// tem as tarefas devolvidas para a fila na hora e é substituído enquanto houver trabalho.
+int run(const campaign_options& options, const char* self) {
+  if (int code = submit(options); code != 0) {
+    return code;
+  }
+  work_queue queue(options.queue);
+  queue.max_attempts = options.attempts;
+  unsigned local     = options.local > 0 ? options.local : std::max(1u, std::thread::hardware_concurrency());
+
+  std::map<pid_t, std::string> workers;
+  unsigned respawns = 0;
+  auto spawn        = [&]() {
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid == 0) {
+      std::string queue_dir = options.queue.string(), attempts = std::to_string(options.attempts),
+                  timeout = std::to_string(options.timeout), heartbeat = format(options.heartbeat),
+                  poll = format(options.poll);
+      ::execl(self, self, "worker", "--queue", queue_dir.c_str(), "--attempts", attempts.c_str(),
+              "--timeout", timeout.c_str(), "--heartbeat", heartbeat.c_str(), "--poll", poll.c_str(),
+              static_cast<char*>(nullptr));
+      std::perror("execl");
+      std::_Exit(127);
+    }
+    if (pid > 0) {
+      workers[pid] = work_queue::worker_id(pid);
+    }
+  };
+  for (unsigned w = 0; w < local; w++) {
+    spawn();
+  }
+
+  while (true) {
+    int status_code = 0;
+    pid_t pid       = ::waitpid(-1, &status_code, WNOHANG);
+    if (pid > 0 && workers.count(pid)) {
+      bool clean = WIFEXITED(status_code) && WEXITSTATUS(status_code) == 0;
+      if (!clean) {
+        size_t requeued = queue.requeue_worker(workers[pid]);
+        std::cerr << "Worker " << workers[pid] << " terminou de forma anormal ("
+                  << (WIFSIGNALED(status_code) ? "sinal " + std::to_string(WTERMSIG(status_code))
+                                               : "saída " + std::to_string(WEXITSTATUS(status_code)))
+                  << "), " << requeued << " tarefa(s) de volta à fila" << std::endl;
+      }
+      workers.erase(pid);
+      if (!clean && !queue.finished() && respawns < 4 * local) {
+        respawns++;
+        spawn();
+      }
+      continue;
+    }
+    if (workers.empty()) {
+      // Todos saíram, mas uma tarefa pode ter voltado para a fila depois da última verificação
+      if (queue.finished() || respawns >= 4 * local) {
+        break;
+      }
+      respawns++;
+      spawn();
+      continue;
+    }
+    queue.requeue_stale(std::chrono::seconds(options.timeout));
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.poll));
+  }
+
+  std::cout << queue.done() << " tarefas concluídas, " << queue.failed() << " falharam" << std::endl;
+  return merge(options);
+}
+
+int main(int argc, char** argv) {
+  campaign_options options;
+  if (argc < 2) {
+    std::cerr << "Uso: campaign run|submit|worker|merge|status --queue <dir> [opções]" << std::endl;
+    return 1;
+  }
+  options.command = argv[1];
+
+  for (int i = 2; i + 1 < argc; i += 2) {
+    std::string arg   = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--queue") {
+      options.queue = value;
+    } else if (arg == "--local") {
+      options.local = static_cast<unsigned>(std::stoi(value));
+    } else if (arg == "--attempts") {
+      options.attempts = std::stoi(value);
+    } else if (arg == "--timeout") {
+      options.timeout = std::stoi(value);
+    } else if (arg == "--heartbeat") {
+      options.heartbeat = std::stod(value);
+    } else if (arg == "--poll") {
+      options.poll = std::stod(value);
+    } else if (arg.rfind("--", 0) == 0 && options.campaign.count(arg.substr(2))) {
+      options.campaign[arg.substr(2)] = value;
+    } else {
+      std::cerr << "Unknown option: " << arg << " " << value << std::endl;
+      return 1;
+    }
+  }
+  if (options.queue.empty()) {
+    std::cerr << "Erro: --queue é obrigatório" << std::endl;
+    return 1;
+  }
+
+  try {
+    if (options.command == "run") {
+      return run(options, "/proc/self/exe");
+    } else if (options.command == "submit") {
+      return submit(options);
+    } else if (options.command == "worker") {
+      return worker(options);
+    } else if (options.command == "merge") {
+      return merge(options);
+    } else if (options.command == "status") {
+      return status(options);
+    }
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+  std::cerr << "Unknown command: " << options.command << std::endl;
+  return 1;
+}
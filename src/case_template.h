@@ -0,0 +1,208 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/fs.h>  // FICLONE
+#endif
+
+// Template de caso do OpenFOAM (ex.: canal_base) lido e analisado uma única vez.
+//
+// Cada arquivo é quebrado em trechos literais e placeholders "${nome}" (nome com letras, dígitos e
+// '_'); renderizar um caso é uma única passada pelos trechos, escrita direto no destino. Placeholders
+// sem valor ficam como estão no arquivo (ex.: "${0%/*}" nos scripts). Arquivos sem nenhum
+// placeholder resolvido não mudam entre casos e são clonados (reflink) ou, se o sistema de arquivos
+// não suportar, copiados. Em ambos os casos o arquivo do caso é independente do template e pode ser
+// reescrito depois (ex.: constant/reactions exportado do mecanismo).
+
+using template_values = std::map<std::string, std::string>;
+
+class case_template {
+ public:
+  explicit case_template(const std::filesystem::path& dir) : directory_(dir) {
+    if (!std::filesystem::is_directory(dir)) {
+      throw std::runtime_error("case_template: diretório não encontrado " + dir.string());
+    }
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(dir)) {
+      auto relative = std::filesystem::relative(entry.path(), dir).generic_string();
+      if (entry.is_directory()) {
+        directories_.push_back(relative);
+      } else if (entry.is_regular_file()) {
+        files_.emplace(relative, parse(entry.path()));
+      }
+    }
+  }
+
+  const std::filesystem::path& directory() const { return directory_; }
+
+  bool contains(const std::string& relative) const { return files_.count(relative) > 0; }
+
+  // Gera o caso inteiro em dest (que deve existir e estar vazio). Para cada placeholder procura
+  // primeiro em per_file[arquivo] e depois em common.
+  void render(const std::filesystem::path& dest,
+              const template_values& common,
+              const std::map<std::string, template_values>& per_file = {},
+              const std::set<std::string>& exclude = {}) const {
+    static const template_values no_values;
+    for (const auto& relative : directories_) {
+      std::filesystem::create_directories(dest / relative);
+    }
+    for (const auto& [relative, file] : files_) {
+      if (exclude.count(relative)) {
+        continue;
+      }
+      auto values = per_file.find(relative);
+      emit(file, dest / relative, common, values == per_file.end() ? no_values : values->second);
+    }
+  }
+
+  // Renderiza um único arquivo do template em um destino qualquer (ex.: 0/Y_temp -> 0/CH4)
+  void renderFile(const std::string& relative,
+                  const std::filesystem::path& dest_file,
+                  const template_values& values) const {
+    static const template_values no_values;
+    auto file = files_.find(relative);
+    if (file == files_.end()) {
+      throw std::runtime_error("case_template: arquivo não encontrado no template " + relative);
+    }
+    emit(file->second, dest_file, values, no_values);
+  }
+
+ private:
+  struct segment {
+    std::string text;  // Trecho literal ou nome do placeholder
+    bool placeholder;
+  };
+
+  struct template_file {
+    std::filesystem::path source;
+    std::vector<segment> segments;
+    size_t literal_size = 0;
+  };
+
+  std::filesystem::path directory_;
+  std::vector<std::string> directories_;
+  std::map<std::string, template_file> files_;
+
+  static bool isNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+  }
+
+  static template_file parse(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+      throw std::runtime_error("case_template: não foi possível ler " + path.string());
+    }
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    template_file file{path, {}, 0};
+    size_t literal_start = 0;
+    size_t pos           = 0;
+    while ((pos = content.find("${", pos)) != std::string::npos) {
+      size_t end = pos + 2;
+      while (end < content.size() && isNameChar(content[end])) {
+        end++;
+      }
+      if (end == pos + 2 || end >= content.size() || content[end] != '}') {
+        pos += 2;
+        continue;
+      }
+      if (pos > literal_start) {
+        file.segments.push_back({content.substr(literal_start, pos - literal_start), false});
+        file.literal_size += pos - literal_start;
+      }
+      file.segments.push_back({content.substr(pos + 2, end - pos - 2), true});
+      literal_start = pos = end + 1;
+    }
+    if (literal_start < content.size()) {
+      file.segments.push_back({content.substr(literal_start), false});
+      file.literal_size += content.size() - literal_start;
+    }
+    return file;
+  }
+
+  static const std::string* lookup(const std::string& name,
+                                   const template_values& primary,
+                                   const template_values& secondary) {
+    if (auto it = secondary.find(name); it != secondary.end()) {
+      return &it->second;
+    }
+    if (auto it = primary.find(name); it != primary.end()) {
+      return &it->second;
+    }
+    return nullptr;
+  }
+
+  static void emit(const template_file& file,
+                   const std::filesystem::path& dest,
+                   const template_values& primary,
+                   const template_values& secondary) {
+    // Uma passada para saber se algo muda e o tamanho final, outra para montar o conteúdo
+    size_t size      = file.literal_size;
+    bool substituted = false;
+    for (const auto& seg : file.segments) {
+      if (seg.placeholder) {
+        const auto* value = lookup(seg.text, primary, secondary);
+        substituted |= value != nullptr;
+        size += value ? value->size() : seg.text.size() + 3;
+      }
+    }
+    if (!substituted) {
+      link(file.source, dest);
+      return;
+    }
+
+    std::string content;
+    content.reserve(size);
+    for (const auto& seg : file.segments) {
+      if (!seg.placeholder) {
+        content += seg.text;
+      } else if (const auto* value = lookup(seg.text, primary, secondary)) {
+        content += *value;
+      } else {
+        content += "${" + seg.text + "}";
+      }
+    }
+
+    std::filesystem::remove(dest);
+    std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+    if (!out.write(content.data(), static_cast<std::streamsize>(content.size()))) {
+      throw std::runtime_error("case_template: não foi possível escrever " + dest.string());
+    }
+    out.close();
+    std::filesystem::permissions(dest, std::filesystem::status(file.source).permissions());
+  }
+
+  // Reflink (cópia copy-on-write, btrfs/xfs), senão cópia comum. Nunca hard link: o caso não pode
+  // compartilhar o inode com o template, ou uma reescrita no caso alteraria o canal_base
+  static void link(const std::filesystem::path& source, const std::filesystem::path& dest) {
+    std::filesystem::remove(dest);
+#ifdef FICLONE
+    int from = ::open(source.c_str(), O_RDONLY);
+    if (from >= 0) {
+      int to = ::open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+      bool cloned = to >= 0 && ::ioctl(to, FICLONE, from) == 0;
+      if (to >= 0) {
+        ::close(to);
+      }
+      ::close(from);
+      if (cloned) {
+        std::filesystem::permissions(dest, std::filesystem::status(source).permissions());
+        return;
+      }
+      std::filesystem::remove(dest);
+    }
+#endif
+    std::filesystem::copy_file(source, dest, std::filesystem::copy_options::overwrite_existing);
+  }
+};
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Topologia em blocos hexaédricos do canal, na mesma convenção do blockMesh: vértices em mm
+// (convertToMeters 0.001), blocos "hex (v0 .. v7) (nx ny nz) simpleGrading (gx gy gz)".
+// As células são numeradas como no blockMesh: bloco a bloco, e dentro de cada bloco com i variando
+// mais rápido, depois j, depois k.
+
+// Trecho de um grading multi-seção do blockMesh: (comprimento células razão)
+struct grading_section {
+  double length;  // mm
+  int cells;
+  double ratio;
+};
+
+struct mesh_block {
+  std::string description;        // Comentário escrito no blockMeshDict
+  std::array<int, 8> vertices;
+  std::array<int, 3> cells;
+  std::array<double, 3> grading;  // Razão de expansão (última / primeira célula) em cada direção
+  std::vector<grading_section> grading_x = {};  // Se não vazio, substitui grading[0]
+};
+
+// Patch do contorno: faces de bloco dadas pelos 4 vértices, como no blockMeshDict. Faces externas
+// que não estão em nenhum patch vão para defaultFaces (empty), como no blockMesh.
+struct mesh_patch {
+  std::string name;
+  std::string type;  // patch, wall, symmetryPlane...
+  std::vector<std::array<int, 4>> faces;
+};
+
+struct channel_mesh {
+  std::vector<std::array<double, 3>> vertices;  // mm
+  std::vector<mesh_block> blocks;
+  std::vector<mesh_patch> patches;
+
+  long nCells() const {
+    long n = 0;
+    for (const auto& block : blocks) {
+      n += static_cast<long>(block.cells[0]) * block.cells[1] * block.cells[2];
+    }
+    return n;
+  }
+
+  // Posição relativa [0, 1] do nó i de uma aresta com n células e razão de expansão ratio
+  static double gradedPosition(double i, int n, double ratio) {
+    if (std::abs(ratio - 1.0) < 1e-12 || n < 2) {
+      return i / n;
+    }
+    double q = std::pow(ratio, 1.0 / (n - 1));
+    return (1.0 - std::pow(q, i)) / (1.0 - std::pow(q, n));
+  }
+
+  // Posição relativa do nó i na direção dir do bloco, considerando o grading multi-seção em x
+  static double nodePosition(const mesh_block& block, int dir, double i) {
+    if (dir != 0 || block.grading_x.empty()) {
+      return gradedPosition(i, block.cells[dir], block.grading[dir]);
+    }
+    double total = 0.0;
+    for (const auto& section : block.grading_x) {
+      total += section.length;
+    }
+    double start = 0.0;
+    for (const auto& section : block.grading_x) {
+      if (i <= section.cells || &section == &block.grading_x.back()) {
+        return (start + section.length * gradedPosition(i, section.cells, section.ratio)) / total;
+      }
+      i -= section.cells;
+      start += section.length;
+    }
+    return 1.0;
+  }
+
+  // Interpolação trilinear entre os 8 vértices do bloco nas coordenadas relativas (s, t, u)
+  std::array<double, 3> blockPoint(const mesh_block& block, double s, double t, double u) const {
+    const double w[8] = {(1 - s) * (1 - t) * (1 - u),
+                         s * (1 - t) * (1 - u),
+                         s * t * (1 - u),
+                         (1 - s) * t * (1 - u),
+                         (1 - s) * (1 - t) * u,
+                         s * (1 - t) * u,
+                         s * t * u,
+                         (1 - s) * t * u};
+    std::array<double, 3> point{0.0, 0.0, 0.0};
+    for (int v = 0; v < 8; v++) {
+      for (int d = 0; d < 3; d++) {
+        point[d] += w[v] * vertices[block.vertices[v]][d];
+      }
+    }
+    return point;
+  }
+
+  // Centros das células (mm) na ordem do blockMesh. Como a interpolação é multilinear, a média dos
+  // 8 cantos de uma célula é o ponto nas coordenadas relativas médias.
+  std::vector<std::array<double, 3>> cellCentres() const {
+    std::vector<std::array<double, 3>> centres;
+    centres.reserve(nCells());
+    for (const auto& block : blocks) {
+      auto [nx, ny, nz] = block.cells;
+      for (int k = 0; k < nz; k++) {
+        double u = 0.5 * (nodePosition(block, 2, k) + nodePosition(block, 2, k + 1));
+        for (int j = 0; j < ny; j++) {
+          double t = 0.5 * (nodePosition(block, 1, j) + nodePosition(block, 1, j + 1));
+          for (int i = 0; i < nx; i++) {
+            double s = 0.5 * (nodePosition(block, 0, i) + nodePosition(block, 0, i + 1));
+            centres.push_back(blockPoint(block, s, t, u));
+          }
+        }
+      }
+    }
+    return centres;
+  }
+
+  std::string blockMeshVertices() const {
+    std::string text;
+    for (size_t v = 0; v < vertices.size(); v++) {
+      text += "    (" + std::to_string(vertices[v][0]) + " " + std::to_string(vertices[v][1]) +
+              " " + std::to_string(vertices[v][2]) + ")  // Vertex " + std::to_string(v) + "\n";
+    }
+    return text;
+  }
+
+  std::string blockMeshBlocks() const {
+    std::string text;
+    for (const auto& block : blocks) {
+      text += "    // " + block.description + "\n    hex (";
+      for (int v = 0; v < 8; v++) {
+        text += std::to_string(block.vertices[v]) + (v < 7 ? " " : ")\n");
+      }
+      text += "    (" + std::to_string(block.cells[0]) + " " + std::to_string(block.cells[1]) +
+              " " + std::to_string(block.cells[2]) + ")\n";
+      std::string grading_x = std::to_string(block.grading[0]);
+      if (!block.grading_x.empty()) {
+        grading_x = "(";
+        for (const auto& section : block.grading_x) {
+          grading_x += "(" + std::to_string(section.length) + " " +
+                       std::to_string(section.cells) + " " + std::to_string(section.ratio) + ")";
+        }
+        grading_x += ")";
+      }
+      text += "    simpleGrading (" + grading_x + " " + std::to_string(block.grading[1]) + " " +
+              std::to_string(block.grading[2]) + ")\n\n";
+    }
+    return text;
+  }
+
+  std::string blockMeshBoundary() const {
+    std::string text;
+    for (const auto& patch : patches) {
+      text += "    " + patch.name + "\n    {\n        type " + patch.type +
+              ";\n        faces\n        (\n";
+      for (const auto& face : patch.faces) {
+        text += "            (" + std::to_string(face[0]) + " " + std::to_string(face[1]) + " " +
+                std::to_string(face[2]) + " " + std::to_string(face[3]) + ")\n";
+      }
+      text += "        );\n    }\n";
+    }
+    return text;
+  }
+};
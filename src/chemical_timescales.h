@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cantera/base/Solution.h"
+#include "cantera/numerics/eigen_dense.h"
+#include "lib.h"
+
+// Escalas de tempo químicas ao longo de uma chama 1-D: autovalores do jacobiano do termo fonte
+// químico (reator adiabático a pressão constante, variáveis T e Y_k) em cada ponto do perfil.
+//
+// O jacobiano é montado por diferenças finitas sobre o Cantera. Os modos conservados (elementos e
+// entalpia) têm autovalor ~0 e são descartados; dos restantes, tau_fast = 1/max|Re(lambda)| e
+// tau_slow = 1/min|Re(lambda)|, e a razão de rigidez é tau_slow / tau_fast. "Ativo" é o que está na
+// zona de reação (liberação de calor >= 1% do pico): fora dela a química está congelada e os modos
+// rápidos não limitam o integrador.
+
+struct timescale_point {
+  double z;             // m
+  double T;             // K
+  double heat_release;  // W/m^3
+  double tau_fast;      // s
+  double tau_slow;      // s
+  double stiffness;     // tau_slow / tau_fast
+  bool explosive;       // Algum Re(lambda) > 0 (modo explosivo)
+};
+
+namespace timescale_detail {
+
+// dx/dt do reator adiabático a pressão constante, x = (T, Y_1..Y_K)
+void chemical_source(std::shared_ptr<Cantera::Solution> sol,
+                     double pressure,
+                     const std::vector<double>& x,
+                     std::vector<double>& dxdt) {
+  auto gas   = sol->thermo();
+  size_t nsp = gas->nSpecies();
+  std::vector<double> wdot(nsp), h(nsp);
+  // Sem normalizar: setState_TPY reescalaria as frações perturbadas e cada coluna do jacobiano
+  // ganharia um termo de renormalização
+  gas->setMassFractions_NoNorm(&x[1]);
+  gas->setState_TP(x[0], pressure);
+  sol->kinetics()->getNetProductionRates(wdot.data());
+  gas->getPartialMolarEnthalpies(h.data());
+
+  double rho = gas->density();
+  double q   = 0.0;
+  for (size_t k = 0; k < nsp; k++) {
+    dxdt[k + 1] = wdot[k] * gas->molecularWeight(k) / rho;
+    q -= h[k] * wdot[k];
+  }
+  dxdt[0] = q / (rho * gas->cp_mass());
+}
+
+}  // namespace timescale_detail
+
+timescale_point chemical_timescales(std::shared_ptr<Cantera::Solution> sol,
+                                    double pressure,
+                                    double T,
+                                    const std::vector<double>& Y) {
+  size_t n = Y.size() + 1;
+  std::vector<double> x(n), f0(n), f1(n);
+  x[0] = T;
+  std::copy(Y.begin(), Y.end(), x.begin() + 1);
+  timescale_detail::chemical_source(sol, pressure, x, f0);
+
+  Eigen::MatrixXd jacobian(n, n);
+  for (size_t j = 0; j < n; j++) {
+    // Piso absoluto sqrt(eps) nas espécies: com um passo relativo, traços (Y ~ 1e-8) dariam
+    // perturbações no nível do arredondamento de f
+    double delta = j == 0 ? 1e-7 * std::max(std::abs(x[j]), 1.0)
+                          : std::max(1e-7 * std::abs(x[j]),
+                                     std::sqrt(std::numeric_limits<double>::epsilon()));
+    auto xp      = x;
+    xp[j] += delta;
+    timescale_detail::chemical_source(sol, pressure, xp, f1);
+    for (size_t i = 0; i < n; i++) {
+      jacobian(i, j) = (f1[i] - f0[i]) / delta;
+    }
+  }
+
+  timescale_point point{0.0, T, 0.0, 0.0, 0.0, 1.0, false};
+  Eigen::EigenSolver<Eigen::MatrixXd> solver(jacobian, false);
+  if (solver.info() != Eigen::Success) {
+    return point;
+  }
+  auto eigenvalues = solver.eigenvalues();
+  double fastest   = 0.0;
+  for (long i = 0; i < static_cast<long>(eigenvalues.size()); i++) {
+    fastest = std::max(fastest, std::abs(eigenvalues[i].real()));
+  }
+  // Modos conservados: |Re(lambda)| no nível do ruído das diferenças finitas
+  double noise   = std::max(1e-8 * fastest, 1e-3);
+  double slowest = std::numeric_limits<double>::infinity();
+  for (long i = 0; i < static_cast<long>(eigenvalues.size()); i++) {
+    double rate = std::abs(eigenvalues[i].real());
+    if (rate > noise) {
+      slowest         = std::min(slowest, rate);
+      point.explosive = point.explosive || eigenvalues[i].real() > noise;
+    }
+  }
+  if (fastest > noise) {
+    point.tau_fast  = 1.0 / fastest;
+    point.tau_slow  = 1.0 / slowest;
+    point.stiffness = fastest / slowest;
+  }
+  return point;
+}
+
+// Um ponto por nó do perfil (chama resolvida com flamespeed(..., &profile) no mecanismo de sol)
+std::vector<timescale_point> flame_timescales(std::shared_ptr<Cantera::Solution> sol,
+                                              const flame_profile& profile,
+                                              double pressure) {
+  auto gas   = sol->thermo();
+  size_t nsp = gas->nSpecies();
+  std::vector<timescale_point> points;
+  for (size_t n = 0; n < profile.z.size(); n++) {
+    std::vector<double> Y(nsp, 0.0);
+    for (size_t s = 0; s < profile.species.size(); s++) {
+      size_t k = gas->speciesIndex(profile.species[s]);
+      if (k != Cantera::npos) {
+        Y[k] = profile.Y[s][n];
+      }
+    }
+    auto point = chemical_timescales(sol, pressure, profile.T[n], Y);
+    point.z    = profile.z[n];
+
+    std::vector<double> x(nsp + 1), dxdt(nsp + 1);
+    x[0] = profile.T[n];
+    std::copy(Y.begin(), Y.end(), x.begin() + 1);
+    timescale_detail::chemical_source(sol, pressure, x, dxdt);
+    point.heat_release = dxdt[0] * gas->density() * gas->cp_mass();
+    points.push_back(point);
+  }
+  return points;
+}
+
+struct stiffness_summary {
+  double tau_fast_active;  // Escala mais rápida na zona de reação, s
+  double tau_slow_active;  // Escala mais lenta (não conservada) na zona de reação, s
+  double max_stiffness;    // Maior razão de rigidez na zona de reação
+  double tau_flame;        // Tempo de residência na chama, espessura / S_L, s
+};
+
+stiffness_summary summarize_stiffness(const std::vector<timescale_point>& points,
+                                      const thermo_state& state) {
+  double q_peak = 0.0;
+  for (const auto& point : points) {
+    q_peak = std::max(q_peak, point.heat_release);
+  }
+  stiffness_summary summary{std::numeric_limits<double>::infinity(), 0.0, 1.0, 0.0};
+  for (const auto& point : points) {
+    if (point.heat_release < 0.01 * q_peak || point.tau_fast <= 0.0) {
+      continue;
+    }
+    summary.tau_fast_active = std::min(summary.tau_fast_active, point.tau_fast);
+    summary.tau_slow_active = std::max(summary.tau_slow_active, point.tau_slow);
+    summary.max_stiffness   = std::max(summary.max_stiffness, point.stiffness);
+  }
+  summary.tau_flame = state.flamespeed > 0.0 ? state.thickness / state.flamespeed : 0.0;
+  return summary;
+}
+
+// Ajustes de constant/chemistryProperties e limites de passo de tempo do caso CFD
+struct integrator_settings {
+  std::string solver;                 // chemistryType.solver: EulerImplicit ou ode (seulex)
+  double initial_chemical_time_step;  // initialChemicalTimeStep, s
+  double eps;                         // odeCoeffs.eps
+  double c_tau_chem;                  // EulerImplicitCoeffs.cTauChem
+  double min_delta_t;                 // s: abaixo disso o passo só resolve modos em equilíbrio
+  double max_delta_t;                 // s: a chama atravessa a própria espessura em >= 10 passos
+};
+
+// Potência de 10 (mantissa 1, 2 ou 5) imediatamente abaixo de value
+double round_down_125(double value) {
+  if (!(value > 0.0) || !std::isfinite(value)) {
+    return value;
+  }
+  double decade = std::pow(10.0, std::floor(std::log10(value)));
+  for (double mantissa : {5.0, 2.0, 1.0}) {
+    if (mantissa * decade <= value) {
+      return mantissa * decade;
+    }
+  }
+  return decade;
+}
+
+// Regras: o primeiro subpasso químico resolve o modo ativo mais rápido; com rigidez acima de 1e4
+// o EulerImplicit precisa de subpassos da ordem de tau_fast e o seulex (extrapolação implícita,
+// passo adaptativo) compensa; cTauChem limita o subpasso do EulerImplicit a uma fração da escala
+// química, menor quanto mais rígido; eps mais apertado quando os modos rápidos se acoplam à chama.
+integrator_settings recommend_integrator(const stiffness_summary& summary) {
+  integrator_settings settings{};
+  bool stiff                          = summary.max_stiffness > 1e4;
+  settings.solver                     = stiff ? "ode" : "EulerImplicit";
+  settings.initial_chemical_time_step = round_down_125(summary.tau_fast_active);
+  settings.eps                        = summary.max_stiffness > 1e6 ? 0.01 : 0.05;
+  settings.c_tau_chem                 = stiff ? 0.1 : 1.0;
+  settings.min_delta_t                = round_down_125(summary.tau_fast_active);
+  settings.max_delta_t                = round_down_125(0.1 * summary.tau_flame);
+  return settings;
+}
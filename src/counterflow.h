@@ -0,0 +1,230 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cantera/base/Solution.h"
+#include "cantera/oneD/DomainFactory.h"
+#include "cantera/onedim.h"
+#include "telemetry.h"
+
+// Chama difusiva em contracorrente (combustível em z = 0, oxidante em z = width) e a taxa de
+// estiramento de extinção, ao lado da chama livre do flamespeed() (lib.h).
+//
+// O ramo superior (chama acesa) é percorrido até o ponto de virada por continuação com controle de
+// temperatura em dois pontos (two-point control do Cantera 3): a temperatura é fixada em um ponto
+// de cada lado da chama e as velocidades de entrada viram incógnitas. Cada passo baixa as duas
+// temperaturas de controle e resolve a partir da solução anterior (o Sim1D guarda o estado), então
+// o estiramento cresce ao longo do ramo até a extinção, onde passa por um máximo e começa a cair
+// (ramo intermediário). Se um passo não converge ou cai na solução apagada, a solução anterior é
+// restaurada e o passo de temperatura é dividido por dois.
+//
+// Estiramento global do lado do oxidante (Seshadri & Williams), o usual para comparar mecanismos:
+//   a = 2 |u_o| / L (1 + |u_f| sqrt(rho_f) / (|u_o| sqrt(rho_o)))
+// e o máximo local max |du/dz| ao longo da chama.
+
+struct counterflow_conditions {
+  std::string fuel     = "CH4";
+  std::string oxidizer = "O2:1, N2:3.76";
+  double T_fuel        = 300.0;            // K
+  double T_oxidizer    = 300.0;            // K
+  double pressure      = Cantera::OneBar;  // Pa
+  double width         = 0.018;            // m, distância entre os bocais
+  double mdot_fuel     = 0.24;             // kg/m^2/s, ponto de partida no ramo superior
+  double mdot_oxidizer = 0.72;             // kg/m^2/s
+};
+
+struct continuation_options {
+  double control_fraction         = 0.95;   // T_controle = T_min + f (T_max - T_min) no começo
+  double temperature_step         = 20.0;   // K por passo
+  double min_temperature_step     = 0.5;    // K: abaixo disso a continuação desiste
+  double extinguished_temperature = 900.0;  // K: T_max abaixo disso é a solução apagada
+  int max_steps                   = 500;
+  int past_turning_point          = 3;  // Passos com estiramento caindo que confirmam a virada
+  bool refine_grid                = true;
+  int loglevel                    = 0;
+};
+
+struct counterflow_point {
+  double T_max;          // K
+  double strain_global;  // 1/s, lado do oxidante
+  double strain_max;     // 1/s, max |du/dz|
+  double u_fuel;         // m/s
+  double u_oxidizer;     // m/s (módulo)
+  size_t grid_points;
+};
+
+struct extinction_result {
+  std::vector<counterflow_point> branch;  // Ramo superior, do ponto de partida à virada
+  counterflow_point extinction;           // Ponto de maior estiramento global
+  bool turning_point;                     // Virada confirmada (senão, extinction é um limite inferior)
+  size_t solves;
+  size_t failed_solves;
+};
+
+extinction_result extinction_strain(std::shared_ptr<Cantera::Solution> sol,
+                                    const counterflow_conditions& conditions = {},
+                                    const continuation_options& options      = {}) {
+  auto gas   = sol->thermo();
+  size_t nsp = gas->nSpecies();
+  double p   = conditions.pressure;
+  double L   = conditions.width;
+
+  // ===== Estados das entradas e da chama estequiométrica (estimativa inicial) =====
+  std::vector<double> X_fuel(nsp), Y_fuel(nsp), X_oxidizer(nsp), Y_oxidizer(nsp), Y_flame(nsp);
+  gas->setState_TPX(conditions.T_fuel, p, conditions.fuel);
+  gas->getMoleFractions(X_fuel.data());
+  gas->getMassFractions(Y_fuel.data());
+  double rho_fuel = gas->density();
+  gas->setState_TPX(conditions.T_oxidizer, p, conditions.oxidizer);
+  gas->getMoleFractions(X_oxidizer.data());
+  gas->getMassFractions(Y_oxidizer.data());
+  double rho_oxidizer = gas->density();
+
+  gas->setEquivalenceRatio(1.0, conditions.fuel, conditions.oxidizer);
+  double Z_st = gas->mixtureFraction(conditions.fuel, conditions.oxidizer);
+  gas->setState_TP(Z_st * conditions.T_fuel + (1.0 - Z_st) * conditions.T_oxidizer, p);
+  gas->equilibrate("HP");
+  gas->getMassFractions(Y_flame.data());
+  double T_flame = gas->temperature();
+
+  // ===== Domínios =====
+  auto fuel_inlet = Cantera::newDomain<Cantera::Inlet1D>("inlet", sol, "fuel_inlet");
+  fuel_inlet->setMoleFractions(X_fuel.data());
+  fuel_inlet->setMdot(conditions.mdot_fuel);
+  fuel_inlet->setTemperature(conditions.T_fuel);
+
+  auto flow = Cantera::newDomain<Cantera::Flow1D>("gas-flow", sol, "flow");
+  flow->setAxisymmetricFlow();
+  int nz = 8;
+  std::vector<double> z(nz);
+  for (int iz = 0; iz < nz; iz++) {
+    z[iz] = L * iz / (nz - 1);
+  }
+  flow->setupGrid(z.size(), z.data());
+
+  auto oxidizer_inlet = Cantera::newDomain<Cantera::Inlet1D>("inlet", sol, "oxidizer_inlet");
+  oxidizer_inlet->setMoleFractions(X_oxidizer.data());
+  oxidizer_inlet->setMdot(conditions.mdot_oxidizer);
+  oxidizer_inlet->setTemperature(conditions.T_oxidizer);
+
+  std::vector<std::shared_ptr<Cantera::Domain1D>> domains{fuel_inlet, flow, oxidizer_inlet};
+  Cantera::Sim1D flame(domains);
+  int flowdomain = 1;
+
+  // Estimativa inicial: plano de estagnação pelo balanço de quantidade de movimento, escoamento
+  // potencial (u linear, spread_rate constante) e a chama em equilíbrio no plano de estagnação
+  double u_fuel     = conditions.mdot_fuel / rho_fuel;
+  double u_oxidizer = conditions.mdot_oxidizer / rho_oxidizer;
+  double x0         = std::sqrt(rho_fuel) * u_fuel /
+                      (std::sqrt(rho_fuel) * u_fuel + std::sqrt(rho_oxidizer) * u_oxidizer);
+  std::vector<double> locs{0.0, x0, 1.0};
+  std::vector<double> value;
+  value = {u_fuel, 0.0, -u_oxidizer};
+  flame.setInitialGuess("velocity", locs, value);
+  value = std::vector<double>(3, (u_fuel + u_oxidizer) / L);
+  flame.setInitialGuess("spread_rate", locs, value);
+  value = {conditions.T_fuel, T_flame, conditions.T_oxidizer};
+  flame.setInitialGuess("T", locs, value);
+  for (size_t k = 0; k < nsp; k++) {
+    value = {Y_fuel[k], Y_flame[k], Y_oxidizer[k]};
+    flame.setInitialGuess(gas->speciesName(k), locs, value);
+  }
+  flame.setRefineCriteria(flowdomain, 3.0, 0.1, 0.2);
+
+  auto measure = [&]() {
+    size_t np = flow->nPoints();
+    size_t iT = flow->componentIndex("T");
+    size_t iu = flow->componentIndex("velocity");
+    counterflow_point point{0.0, 0.0, 0.0, 0.0, 0.0, np};
+    for (size_t n = 0; n < np; n++) {
+      point.T_max = std::max(point.T_max, flame.value(flowdomain, iT, n));
+      if (n > 0) {
+        double dudz = (flame.value(flowdomain, iu, n) - flame.value(flowdomain, iu, n - 1)) /
+                      (flow->z(n) - flow->z(n - 1));
+        point.strain_max = std::max(point.strain_max, std::abs(dudz));
+      }
+    }
+    point.u_fuel     = std::abs(flame.value(flowdomain, iu, 0));
+    point.u_oxidizer = std::abs(flame.value(flowdomain, iu, np - 1));
+    if (point.u_oxidizer > 0.0) {
+      point.strain_global = 2.0 * point.u_oxidizer / L *
+                            (1.0 + point.u_fuel * std::sqrt(rho_fuel) /
+                                       (point.u_oxidizer * std::sqrt(rho_oxidizer)));
+    }
+    return point;
+  };
+
+  extinction_result result{{}, {}, false, 0, 0};
+  auto solve = [&]() {
+    auto start     = std::chrono::steady_clock::now();
+    bool converged = true;
+    try {
+      flame.solve(options.loglevel, options.refine_grid);
+    } catch (Cantera::CanteraError&) {
+      converged = false;
+    }
+    telemetry().record_solve(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+        converged, flow->nPoints());
+    (converged ? result.solves : result.failed_solves)++;
+    return converged;
+  };
+
+  // ===== Primeira solução: ramo superior no estiramento de partida =====
+  flow->solveEnergyEqn();
+  if (!solve()) {
+    throw Cantera::CanteraError("extinction_strain", "a chama de partida não convergiu");
+  }
+  result.extinction = measure();
+  if (result.extinction.T_max < options.extinguished_temperature) {
+    throw Cantera::CanteraError("extinction_strain", "a chama de partida está apagada");
+  }
+  result.branch.push_back(result.extinction);
+
+  // ===== Continuação com controle em dois pontos =====
+  double T_min     = std::min(conditions.T_fuel, conditions.T_oxidizer);
+  double T_control = T_min + options.control_fraction * (result.extinction.T_max - T_min);
+  flow->enableTwoPointControl(true);
+  flame.setLeftControlPoint(T_control);
+  flame.setRightControlPoint(T_control);
+
+  // Última solução aceita, para voltar quando um passo falha
+  auto saved = (std::filesystem::temp_directory_path() /
+                ("counterflow_" + std::to_string(::getpid()) + ".yaml"))
+                   .string();
+  double step    = options.temperature_step;
+  int decreasing = 0;
+  for (int n = 0; n < options.max_steps && step >= options.min_temperature_step; n++) {
+    flame.save(saved, "continuation", "Última solução aceita", true);
+    flow->setLeftControlPointTemperature(flow->leftControlPointTemperature() - step);
+    flow->setRightControlPointTemperature(flow->rightControlPointTemperature() - step);
+
+    bool accepted = solve();
+    auto point    = accepted ? measure() : counterflow_point{};
+    if (!accepted || point.T_max < options.extinguished_temperature) {
+      flame.restore(saved, "continuation");
+      step *= 0.5;
+      continue;
+    }
+
+    result.branch.push_back(point);
+    if (point.strain_global > result.extinction.strain_global) {
+      result.extinction = point;
+      decreasing        = 0;
+    } else if (++decreasing >= options.past_turning_point) {
+      result.turning_point = true;
+      break;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove(saved, ec);
+  return result;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "foam_reader.h"
+#include "parallel.h"
+
+// Posição da frente de chama e S_L em um caso do OpenFOAM (Plano.md, seção 8.1), sem ParaView.
+//
+// T, U e Qdot são amostrados no eixo de simetria do canal (linha y = y_min, z = z_min): para cada
+// posição x de centro de célula, a célula mais próxima do eixo. A frente de chama é o primeiro x,
+// a partir da entrada, em que T atinge o limiar (ou o pico de Qdot); S_L é a velocidade axial no
+// ponto de inflexão térmico (máximo de dT/dx). Funciona com o caso decomposto (processor*) ou
+// reconstruído.
+
+struct flame_front {
+  double time;
+  double x_flame;       // m (NaN se não houver chama)
+  double flamespeed;    // m/s
+  double x_inflection;  // m
+  double T_max;         // K
+};
+
+bool parse_foam_time(const std::string& name, double& time) {
+  auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), time);
+  return ec == std::errc() && ptr == name.data() + name.size();
+}
+
+class flame_axis {
+ public:
+  // Lê as malhas de todos os domínios (em paralelo) e escolhe as células do eixo
+  explicit flame_axis(const std::filesystem::path& case_dir, unsigned threads = 0) {
+    for (size_t p = 0;
+         std::filesystem::is_directory(case_dir / ("processor" + std::to_string(p)));
+         p++) {
+      domains_.push_back(case_dir / ("processor" + std::to_string(p)));
+    }
+    if (domains_.empty()) {
+      domains_.push_back(case_dir);
+    }
+
+    std::vector<std::vector<std::array<double, 3>>> centres(domains_.size());
+    std::vector<std::array<double, 2>> lower(domains_.size());
+    n_cells_.resize(domains_.size());
+    run(domains_.size(), threads, [&](size_t d) {
+      auto mesh   = read_foam_mesh(domains_[d] / "constant/polyMesh");
+      centres[d]  = mesh.cellCentres();
+      n_cells_[d] = mesh.n_cells;
+      lower[d]    = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+      for (size_t p = 0; p < mesh.points.size(); p += 3) {
+        lower[d][0] = std::min(lower[d][0], mesh.points[p + 1]);
+        lower[d][1] = std::min(lower[d][1], mesh.points[p + 2]);
+      }
+    });
+
+    // Eixo (y_min, z_min); por x de centro de célula, a célula mais próxima dele
+    double y_axis = lower.front()[0];
+    double z_axis = lower.front()[1];
+    for (const auto& bound : lower) {
+      y_axis = std::min(y_axis, bound[0]);
+      z_axis = std::min(z_axis, bound[1]);
+    }
+    std::map<long long, std::pair<double, sample>> nearest;
+    for (size_t d = 0; d < domains_.size(); d++) {
+      for (size_t c = 0; c < centres[d].size(); c++) {
+        auto [x, y, z]  = centres[d][c];
+        double distance = std::hypot(y - y_axis, z - z_axis);
+        auto key        = std::llround(x * 1e9);  // Bins de 1 nm
+        auto it         = nearest.find(key);
+        if (it == nearest.end() || distance < it->second.first) {
+          nearest[key] = {distance, {x, d, c}};
+        }
+      }
+    }
+    for (const auto& [key, entry] : nearest) {
+      samples_.push_back(entry.second);
+    }
+    domain_samples_.resize(domains_.size());
+    for (size_t s = 0; s < samples_.size(); s++) {
+      domain_samples_[samples_[s].domain].push_back(s);
+    }
+  }
+
+  const std::vector<std::filesystem::path>& domains() const { return domains_; }
+
+  // Diretórios de tempo com T (no primeiro domínio), em ordem crescente
+  std::vector<std::string> times() const {
+    std::map<double, std::string> times;
+    for (const auto& entry : std::filesystem::directory_iterator(domains_.front())) {
+      double time;
+      if (entry.is_directory() && parse_foam_time(entry.path().filename().string(), time) &&
+          std::filesystem::exists(entry.path() / "T")) {
+        times.emplace(time, entry.path().filename().string());
+      }
+    }
+    std::vector<std::string> names;
+    for (const auto& [time, name] : times) {
+      names.push_back(name);
+    }
+    return names;
+  }
+
+  // method: "threshold" (T = threshold) ou "qdot" (pico de Qdot; NaN se Qdot não foi escrito)
+  flame_front measure(const std::string& time_name,
+                      const std::string& method,
+                      double threshold,
+                      unsigned threads = 1) const {
+    size_t n = samples_.size();
+    std::vector<double> T(n), Ux(n), Qdot(n, 0.0);
+    bool qdot_missing = false;
+    std::mutex mutex;
+    run(domains_.size(), threads, [&](size_t d) {
+      if (domain_samples_[d].empty()) {
+        return;
+      }
+      auto dir     = domains_[d] / time_name;
+      auto T_field = read_foam_field(dir / "T", 1, n_cells_[d]);
+      auto U_field = read_foam_field(dir / "U", 3, n_cells_[d]);
+      std::vector<double> Qdot_field;
+      if (method == "qdot") {
+        if (std::filesystem::exists(dir / "Qdot")) {
+          Qdot_field = read_foam_field(dir / "Qdot", 1, n_cells_[d]);
+        } else {
+          std::lock_guard<std::mutex> lock(mutex);
+          qdot_missing = true;
+        }
+      }
+      for (auto s : domain_samples_[d]) {
+        size_t cell = samples_[s].cell;
+        T[s]        = T_field[cell];
+        Ux[s]       = U_field[3 * cell];
+        if (!Qdot_field.empty()) {
+          Qdot[s] = Qdot_field[cell];
+        }
+      }
+    });
+
+    double time = 0.0;
+    parse_foam_time(time_name, time);
+    flame_front front{time, std::nan(""), std::nan(""), std::nan(""), 0.0};
+    for (size_t s = 0; s < n; s++) {
+      front.T_max = std::max(front.T_max, T[s]);
+    }
+
+    if (method == "qdot") {
+      if (!qdot_missing) {
+        size_t peak   = std::max_element(Qdot.begin(), Qdot.end()) - Qdot.begin();
+        front.x_flame = samples_[peak].x;
+      }
+    } else {
+      for (size_t s = 1; s < n; s++) {
+        if (T[s - 1] < threshold && T[s] >= threshold) {
+          double w      = (threshold - T[s - 1]) / (T[s] - T[s - 1]);
+          front.x_flame = samples_[s - 1].x + w * (samples_[s].x - samples_[s - 1].x);
+          break;
+        }
+      }
+    }
+
+    // Inflexão térmica: máximo de dT/dx (diferença central em malha não uniforme)
+    double max_gradient = 0.0;
+    for (size_t s = 1; s + 1 < n; s++) {
+      double gradient = (T[s + 1] - T[s - 1]) / (samples_[s + 1].x - samples_[s - 1].x);
+      if (gradient > max_gradient) {
+        max_gradient       = gradient;
+        front.x_inflection = samples_[s].x;
+        front.flamespeed   = Ux[s];
+      }
+    }
+    return front;
+  }
+
+ private:
+  struct sample {
+    double x;
+    size_t domain;
+    size_t cell;
+  };
+
+  std::vector<std::filesystem::path> domains_;
+  std::vector<size_t> n_cells_;
+  std::vector<sample> samples_;
+  std::vector<std::vector<size_t>> domain_samples_;  // Índices em samples_ por domínio
+
+  // parallel_for que repassa a primeira exceção das tarefas para quem chamou
+  template <typename Function>
+  static void run(size_t n, unsigned threads, Function&& function) {
+    std::string error;
+    std::mutex mutex;
+    parallel_for(n, threads, [&](size_t i) {
+      try {
+        function(i);
+      } catch (std::exception& err) {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = err.what();
+      }
+    });
+    if (!error.empty()) {
+      throw std::runtime_error(error);
+    }
+  }
+};
+
+void write_flame_csv(const std::filesystem::path& path, const std::vector<flame_front>& fronts) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("não foi possível escrever " + path.string());
+  }
+  out.precision(8);
+  out << "time,x_flame,flamespeed,x_inflection,T_max\n";
+  for (const auto& front : fronts) {
+    out << front.time << "," << front.x_flame << "," << front.flamespeed << ","
+        << front.x_inflection << "," << front.T_max << "\n";
+  }
+}
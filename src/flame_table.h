@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Tabela de velocidade de chama laminar em uma grade regular phi x T_u x p.
+//
+// Header-only e sem dependência do Cantera, para que solvers/utilitários em C++ possam consultar a
+// tabela sem chamar a cinética em tempo de execução.
+//
+// Formato binário (little-endian, nativo):
+//   char[8]   "FLMTBL01"
+//   uint32    n_phi, n_T, n_p
+//   double    phi[n_phi], T[n_T], p[n_p]
+//   double    dados[n_phi][n_T][n_p][n_fields]   (campos na ordem de flame_table_entry)
+//
+// Pontos em que a chama não convergiu têm NaN em todos os campos; lookup() não os usa.
+
+// Eixo da tabela a partir de "min:max:n" (n pontos igualmente espaçados) ou de um único valor
+std::vector<double> parse_axis(const std::string& spec) {
+  auto first = spec.find(':');
+  if (first == std::string::npos) {
+    return {std::stod(spec)};
+  }
+  auto second = spec.find(':', first + 1);
+  double min  = std::stod(spec.substr(0, first));
+  double max  = std::stod(spec.substr(first + 1, second - first - 1));
+  int n       = std::max(2, std::stoi(spec.substr(second + 1)));
+
+  std::vector<double> axis(n);
+  for (int i = 0; i < n; i++) {
+    axis[i] = min + (max - min) * i / (n - 1);
+  }
+  return axis;
+}
+
+struct flame_table_entry {
+  double flamespeed;  // m/s
+  double Tad;         // K
+  double Tmax;        // K
+  double thickness;   // m
+
+  // Ponto sem chama convergida
+  static flame_table_entry invalid() {
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    return {nan, nan, nan, nan};
+  }
+  bool valid() const { return std::isfinite(flamespeed) && flamespeed > 0.0; }
+};
+
+class flame_table {
+ public:
+  static constexpr size_t n_fields = 4;
+
+  std::vector<double> phi;
+  std::vector<double> T;
+  std::vector<double> p;  // Pa
+  std::vector<double> data;
+
+  flame_table() = default;
+  flame_table(std::vector<double> phi_axis, std::vector<double> T_axis, std::vector<double> p_axis)
+      : phi(std::move(phi_axis)), T(std::move(T_axis)), p(std::move(p_axis)) {
+    data.assign(phi.size() * T.size() * p.size() * n_fields, 0.0);
+  }
+
+  size_t index(size_t i_phi, size_t i_T, size_t i_p) const {
+    return ((i_phi * T.size() + i_T) * p.size() + i_p) * n_fields;
+  }
+
+  flame_table_entry at(size_t i_phi, size_t i_T, size_t i_p) const {
+    const double* v = &data[index(i_phi, i_T, i_p)];
+    return {v[0], v[1], v[2], v[3]};
+  }
+
+  void set(size_t i_phi, size_t i_T, size_t i_p, const flame_table_entry& entry) {
+    double* v = &data[index(i_phi, i_T, i_p)];
+    v[0]      = entry.flamespeed;
+    v[1]      = entry.Tad;
+    v[2]      = entry.Tmax;
+    v[3]      = entry.thickness;
+  }
+
+  bool valid(size_t i_phi, size_t i_T, size_t i_p) const { return at(i_phi, i_T, i_p).valid(); }
+
+  // Índices (i_phi, i_T, i_p) dos pontos sem chama convergida
+  std::vector<std::array<size_t, 3>> invalid_points() const {
+    std::vector<std::array<size_t, 3>> points;
+    for (size_t i = 0; i < phi.size(); i++) {
+      for (size_t j = 0; j < T.size(); j++) {
+        for (size_t k = 0; k < p.size(); k++) {
+          if (!valid(i, j, k)) {
+            points.push_back({i, j, k});
+          }
+        }
+      }
+    }
+    return points;
+  }
+
+  // Interpolação trilinear; valores fora da grade são limitados às bordas. Cantos sem chama
+  // convergida ficam de fora e os pesos dos demais são renormalizados; se nenhum canto com peso
+  // for válido, a consulta é recusada.
+  flame_table_entry lookup(double phi_value, double T_value, double p_value) const {
+    auto [i0, w0] = locate(phi, phi_value);
+    auto [j0, w1] = locate(T, T_value);
+    auto [k0, w2] = locate(p, p_value);
+
+    std::array<double, n_fields> result{};
+    double total = 0.0;
+    for (int di = 0; di < 2; di++) {
+      for (int dj = 0; dj < 2; dj++) {
+        for (int dk = 0; dk < 2; dk++) {
+          double w = (di ? w0 : 1.0 - w0) * (dj ? w1 : 1.0 - w1) * (dk ? w2 : 1.0 - w2);
+          if (w == 0.0) {
+            continue;
+          }
+          size_t i = std::min(i0 + di, phi.size() - 1);
+          size_t j = std::min(j0 + dj, T.size() - 1);
+          size_t k = std::min(k0 + dk, p.size() - 1);
+          if (!valid(i, j, k)) {
+            continue;
+          }
+          const double* v = &data[index(i, j, k)];
+          for (size_t f = 0; f < n_fields; f++) {
+            result[f] += w * v[f];
+          }
+          total += w;
+        }
+      }
+    }
+    if (total <= 0.0) {
+      throw std::runtime_error("flame_table: nenhum ponto válido em volta de phi = " +
+                               std::to_string(phi_value) + ", T = " + std::to_string(T_value) +
+                               ", p = " + std::to_string(p_value));
+    }
+    return {result[0] / total, result[1] / total, result[2] / total, result[3] / total};
+  }
+
+  void write(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("flame_table: não foi possível escrever " + path);
+    }
+    out.write(magic, sizeof(magic));
+    std::uint32_t dims[3] = {static_cast<std::uint32_t>(phi.size()),
+                             static_cast<std::uint32_t>(T.size()),
+                             static_cast<std::uint32_t>(p.size())};
+    out.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    for (const auto* axis : {&phi, &T, &p, &data}) {
+      out.write(reinterpret_cast<const char*>(axis->data()),
+                static_cast<std::streamsize>(axis->size() * sizeof(double)));
+    }
+  }
+
+  static flame_table read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char header[sizeof(magic)];
+    std::uint32_t dims[3];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0 ||
+        !in.read(reinterpret_cast<char*>(dims), sizeof(dims))) {
+      throw std::runtime_error("flame_table: arquivo inválido " + path);
+    }
+    flame_table table{
+        std::vector<double>(dims[0]), std::vector<double>(dims[1]), std::vector<double>(dims[2])};
+    for (auto* axis : {&table.phi, &table.T, &table.p, &table.data}) {
+      if (!in.read(reinterpret_cast<char*>(axis->data()),
+                   static_cast<std::streamsize>(axis->size() * sizeof(double)))) {
+        throw std::runtime_error("flame_table: arquivo truncado " + path);
+      }
+    }
+    return table;
+  }
+
+  // Dicionário OpenFOAM com os eixos e os campos achatados (phi varia mais devagar, p mais rápido).
+  // O OpenFOAM não lê NaN: pontos sem chama convergida têm valid 0 e campos zerados.
+  void writeFoamDictionary(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.is_open()) {
+      throw std::runtime_error("flame_table: não foi possível escrever " + path);
+    }
+    out.precision(8);
+    out << "FoamFile\n{\n    format      ascii;\n    class       dictionary;\n"
+           "    location    \"constant\";\n    object      laminarFlameSpeedTable;\n}\n\n"
+           "// Índice do ponto: (i_phi*nT + i_T)*np + i_p\n\n";
+    writeList(out, "equivalenceRatio", phi);
+    writeList(out, "T", T);
+    writeList(out, "p", p);
+
+    std::vector<double> valid_points(data.size() / n_fields);
+    for (size_t i = 0; i < valid_points.size(); i++) {
+      valid_points[i] = std::isfinite(data[i * n_fields]) && data[i * n_fields] > 0.0 ? 1.0 : 0.0;
+    }
+    writeList(out, "valid", valid_points);
+
+    const char* names[n_fields] = {"Su", "Tad", "Tmax", "deltaL"};
+    for (size_t f = 0; f < n_fields; f++) {
+      std::vector<double> field(data.size() / n_fields);
+      for (size_t i = 0; i < field.size(); i++) {
+        field[i] = valid_points[i] > 0.0 ? data[i * n_fields + f] : 0.0;
+      }
+      writeList(out, names[f], field);
+    }
+  }
+
+ private:
+  static constexpr char magic[8] = {'F', 'L', 'M', 'T', 'B', 'L', '0', '1'};
+
+  static std::pair<size_t, double> locate(const std::vector<double>& axis, double value) {
+    if (axis.size() < 2 || value <= axis.front()) {
+      return {0, 0.0};
+    }
+    if (value >= axis.back()) {
+      return {axis.size() - 1, 0.0};
+    }
+    size_t i = std::upper_bound(axis.begin(), axis.end(), value) - axis.begin() - 1;
+    return {i, (value - axis[i]) / (axis[i + 1] - axis[i])};
+  }
+
+  static void writeList(std::ofstream& out, const std::string& name,
+                        const std::vector<double>& values) {
+    out << name << "\n" << values.size() << "\n(\n";
+    for (auto v : values) {
+      out << "    " << v << "\n";
+    }
+    out << ");\n\n";
+  }
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "channel_mesh.h"
+
+// Escolha do número de subdomínios (processos MPI) a partir do número de células previsto da malha.
+//
+// n = round(células / cells_per_core), limitado a [1, max_cores]. A divisão é hierarchical (x, y, 1):
+// o canal é comprido em x e fino em z, então os cortes vão principalmente ao longo do eixo, com a
+// razão nx/ny o mais próxima possível da razão entre as células nas duas direções (menos faces de
+// interface entre processadores).
+
+struct decomposition_plan {
+  int n_subdomains = 1;
+  std::array<int, 3> n = {1, 1, 1};
+
+  std::string coefficients() const {
+    return "(" + std::to_string(n[0]) + " " + std::to_string(n[1]) + " " + std::to_string(n[2]) +
+           ")";
+  }
+};
+
+// Células ao longo de cada eixo: a maior soma de cells[d] numa cadeia de blocos vizinhos em d (a
+// face +d de um bloco é a face -d do seguinte). Os blocos do canal ficam em sequência ao longo de x,
+// então a extensão em x é a soma deles, não o maior bloco. É também o case_summary::cells_xyz do
+// generate_cfd.
+std::array<long, 3> mesh_extent_cells(const channel_mesh& mesh) {
+  // Vértices das faces -d e +d na ordem do blockMesh
+  static constexpr int faces[3][2][4] = {{{0, 3, 4, 7}, {1, 2, 5, 6}},
+                                         {{0, 1, 4, 5}, {3, 2, 7, 6}},
+                                         {{0, 1, 2, 3}, {4, 5, 6, 7}}};
+  size_t n_blocks            = mesh.blocks.size();
+  std::array<long, 3> extent = {1, 1, 1};
+  for (int d = 0; d < 3; d++) {
+    auto face = [&](size_t b, int side) {
+      std::set<int> vertices;
+      for (int v : faces[d][side]) {
+        vertices.insert(mesh.blocks[b].vertices[v]);
+      }
+      return vertices;
+    };
+    // Maior caminho até cada bloco; cadeias têm no máximo n_blocks blocos
+    std::vector<long> chain(n_blocks);
+    for (size_t b = 0; b < n_blocks; b++) {
+      chain[b] = mesh.blocks[b].cells[d];
+    }
+    for (size_t pass = 1; pass < n_blocks; pass++) {
+      for (size_t a = 0; a < n_blocks; a++) {
+        for (size_t b = 0; b < n_blocks; b++) {
+          if (a != b && face(a, 1) == face(b, 0)) {
+            chain[b] = std::max(chain[b], chain[a] + mesh.blocks[b].cells[d]);
+          }
+        }
+      }
+    }
+    for (auto cells : chain) {
+      extent[d] = std::max(extent[d], cells);
+    }
+  }
+  return extent;
+}
+
+decomposition_plan plan_decomposition(const channel_mesh& mesh,
+                                      double cells_per_core,
+                                      unsigned max_cores = 0) {
+  if (max_cores == 0) {
+    max_cores = std::max(1u, std::thread::hardware_concurrency());
+  }
+  decomposition_plan plan;
+  long n_cells      = mesh.nCells();
+  plan.n_subdomains = static_cast<int>(std::clamp<long>(
+      std::lround(static_cast<double>(n_cells) / std::max(cells_per_core, 1.0)), 1, max_cores));
+
+  // Divisão (a, b) com a*b = n e a/b mais próximo da razão de células x/y (comparada em log)
+  auto extent   = mesh_extent_cells(mesh);
+  double target = std::log(static_cast<double>(extent[0]) / static_cast<double>(extent[1]));
+  double best   = 1e300;
+  for (int b = 1; b <= plan.n_subdomains; b++) {
+    if (plan.n_subdomains % b != 0) {
+      continue;
+    }
+    int a        = plan.n_subdomains / b;
+    double error = std::abs(std::log(static_cast<double>(a) / b) - target);
+    if (error < best) {
+      best   = error;
+      plan.n = {a, b, 1};
+    }
+  }
+  return plan;
+}
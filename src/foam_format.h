@@ -0,0 +1,15 @@
+#pragma once
+
+// Cabeçalho e rodapé padrão dos arquivos escritos para o OpenFOAM
+
+static const char* foam_banner =
+    "/*--------------------------------*- C++ -*----------------------------------*\\\n"
+    "  =========                 |\n"
+    "  \\\\      /  F ield         | OpenFOAM: The Open Source CFD Toolbox\n"
+    "   \\\\    /   O peration     | Website:  https://openfoam.org\n"
+    "    \\\\  /    A nd           | Version:  13\n"
+    "     \\\\/     M anipulation  |\n"
+    "\\*---------------------------------------------------------------------------*/\n";
+
+static const char* foam_footer =
+    "\n// ************************************************************************* //\n";
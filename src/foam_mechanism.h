@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cantera/base/AnyMap.h"
+#include "cantera/base/Solution.h"
+#include "cantera/kinetics/Reaction.h"
+#include "cantera/thermo/Species.h"
+#include "foam_format.h"
+
+// Exporta um mecanismo do Cantera (ex.: output/modified_mechanism.yaml) para os dicionários
+// constant/reactions e constant/thermo.compressibleGas do OpenFOAM (janaf + sutherland).
+// Unidades: o Cantera já guarda as taxas em SI (kmol, m^3, s), as mesmas do OpenFOAM; só a energia
+// de ativação é convertida para temperatura de ativação (Ta = Ea / R).
+
+// Espécies que participam de pelo menos uma reação, mais as que precisam existir no caso mesmo sem
+// reagir (entrada, ar externo, defaultSpecie). Mantém a ordem do mecanismo.
+std::vector<std::string> foam_active_species(std::shared_ptr<Cantera::Solution> sol,
+                                             const std::set<std::string>& keep) {
+  auto gas      = sol->thermo();
+  auto kinetics = sol->kinetics();
+
+  std::set<std::string> used(keep.begin(), keep.end());
+  for (size_t i = 0; i < kinetics->nReactions(); i++) {
+    auto rxn = kinetics->reaction(i);
+    for (const auto* side : {&rxn->reactants, &rxn->products}) {
+      for (const auto& [name, stoich] : *side) {
+        used.insert(name);
+      }
+    }
+  }
+
+  std::vector<std::string> species;
+  for (size_t k = 0; k < gas->nSpecies(); k++) {
+    if (used.count(gas->speciesName(k))) {
+      species.push_back(gas->speciesName(k));
+    }
+  }
+  for (const auto& name : keep) {
+    if (gas->speciesIndex(name) == Cantera::npos) {
+      throw std::runtime_error("foam_mechanism: species " + name + " not in mechanism");
+    }
+  }
+  return species;
+}
+
+// "2O2" / "CH4^0.2"
+std::string foam_reaction_side(const Cantera::Composition& side, const Cantera::Composition& orders) {
+  std::ostringstream out;
+  bool first = true;
+  for (const auto& [name, stoich] : side) {
+    if (name == "M") {
+      continue;
+    }
+    if (!first) {
+      out << " + ";
+    }
+    first = false;
+    if (std::abs(stoich - 1.0) > 1e-12) {
+      out << stoich;
+    }
+    out << name;
+    auto order = orders.find(name);
+    if (order != orders.end() && std::abs(order->second - stoich) > 1e-12) {
+      out << "^" << order->second;
+    }
+  }
+  return out.str();
+}
+
+void foam_arrhenius(std::ostream& out, const Cantera::ArrheniusRate& rate, const std::string& indent) {
+  out << indent << "A               " << rate.preExponentialFactor() << ";\n"
+      << indent << "beta            " << rate.temperatureExponent() << ";\n"
+      << indent << "Ta              " << rate.activationEnergy() / Cantera::GasConstant << ";\n";
+}
+
+void foam_efficiencies(std::ostream& out,
+                       const Cantera::ThirdBody& third_body,
+                       const std::vector<std::string>& species,
+                       const std::string& indent) {
+  out << indent << "coeffs\n" << species.size() << "\n(\n";
+  for (const auto& name : species) {
+    out << "(" << name << " " << third_body.efficiency(name) << ")\n";
+  }
+  out << ")\n" << indent << ";\n";
+}
+
+void write_foam_reactions(std::shared_ptr<Cantera::Solution> sol,
+                          const std::vector<std::string>& species,
+                          const std::string& path) {
+  auto kinetics = sol->kinetics();
+
+  std::ofstream out(path, std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("foam_mechanism: cannot write " + path);
+  }
+  out.precision(10);
+  out << foam_banner << "\nreactions\n{\n";
+
+  size_t n_written = 0;
+  for (size_t i = 0; i < kinetics->nReactions(); i++) {
+    auto rxn             = kinetics->reaction(i);
+    auto rate            = rxn->rate();
+    std::string dir      = rxn->reversible ? "reversible" : "irreversible";
+    // As ordens do Cantera são só dos reagentes: o lado dos produtos não recebe expoente
+    std::string equation = foam_reaction_side(rxn->reactants, rxn->orders) + " = " +
+                           foam_reaction_side(rxn->products, Cantera::Composition{});
+
+    std::ostringstream body;
+    body.precision(10);
+    if (auto arrhenius = std::dynamic_pointer_cast<Cantera::ArrheniusRate>(rate)) {
+      if (rxn->usesThirdBody()) {
+        body << "        type            " << dir << "ThirdBodyArrhenius;\n"
+             << "        reaction        \"" << equation << "\";\n";
+        foam_arrhenius(body, *arrhenius, "        ");
+        foam_efficiencies(body, *rxn->thirdBody(), species, "        ");
+      } else {
+        body << "        type            " << dir << "Arrhenius;\n"
+             << "        reaction        \"" << equation << "\";\n";
+        foam_arrhenius(body, *arrhenius, "        ");
+      }
+    } else if (auto falloff = std::dynamic_pointer_cast<Cantera::FalloffRate>(rate);
+               falloff && !falloff->chemicallyActivated() &&
+               (rate->type() == "Troe" || rate->type() == "Lindemann")) {
+      bool troe = rate->type() == "Troe";
+      body << "        type            " << dir << "Arrhenius" << (troe ? "Troe" : "Lindemann")
+           << "FallOff;\n"
+           << "        reaction        \"" << equation << "\";\n"
+           << "        k0\n        {\n";
+      foam_arrhenius(body, falloff->lowRate(), "            ");
+      body << "        }\n        kInf\n        {\n";
+      foam_arrhenius(body, falloff->highRate(), "            ");
+      body << "        }\n        F\n        {\n";
+      if (troe) {
+        std::vector<double> c;
+        falloff->getFalloffCoeffs(c);
+        body << "            alpha           " << c[0] << ";\n"
+             << "            Tsss            " << c[1] << ";\n"
+             << "            Ts              " << c[2] << ";\n"
+             << "            Tss             " << (c.size() > 3 ? c[3] : 1e30) << ";\n";
+      }
+      body << "        }\n        thirdBodyEfficiencies\n        {\n";
+      foam_efficiencies(body, *rxn->thirdBody(), species, "            ");
+      body << "        }\n";
+    } else {
+      std::cerr << "Warning: skipping reaction " << i << " (" << rxn->equation()
+                << "): rate type '" << rate->type() << "' not supported by the exporter"
+                << std::endl;
+      continue;
+    }
+
+    out << "    un-named-reaction-" << n_written++ << "\n    {\n" << body.str() << "    }\n";
+  }
+  out << "}\n\nTlow            200;\nThigh           3500;\n" << foam_footer;
+}
+
+// Ajuste de Sutherland mu = As*sqrt(T)/(1 + Ts/T) por mínimos quadrados em sqrt(T)/mu = a + b/T
+std::pair<double, double> foam_sutherland_fit(std::shared_ptr<Cantera::Solution> sol, size_t k) {
+  auto gas       = sol->thermo();
+  auto transport = sol->transport();
+
+  std::vector<double> mu(gas->nSpecies());
+  double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+  int n     = 0;
+  for (double T = 300.0; T <= 3000.0; T += 100.0, n++) {
+    gas->setState_TP(T, Cantera::OneAtm);
+    transport->getSpeciesViscosities(mu.data());
+    double x = 1.0 / T;
+    double y = std::sqrt(T) / mu[k];
+    sx += x;
+    sy += y;
+    sxx += x * x;
+    sxy += x * y;
+  }
+  double b = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+  double a = (sy - b * sx) / n;
+  return {1.0 / a, b / a};
+}
+
+void write_foam_thermo(std::shared_ptr<Cantera::Solution> sol,
+                       const std::vector<std::string>& species,
+                       const std::string& path) {
+  auto gas = sol->thermo();
+
+  std::ofstream out(path, std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("foam_mechanism: cannot write " + path);
+  }
+  out.precision(10);
+  out << foam_banner << "\nspecies\n(\n";
+  for (const auto& name : species) {
+    out << "    " << name << "\n";
+  }
+  out << ");\n";
+
+  for (const auto& name : species) {
+    size_t k           = gas->speciesIndex(name);
+    auto sp            = gas->species(k);
+    auto params        = sp->parameters(gas.get());
+    const auto& thermo = params["thermo"];
+    if (thermo["model"].asString() != "NASA7") {
+      throw std::runtime_error("foam_mechanism: species " + name + " is not NASA7 (janaf)");
+    }
+    auto ranges = thermo["temperature-ranges"].asVector<double>();
+    auto data   = thermo["data"].asVector<std::vector<double>>();
+    // Faixa única: mesmo polinômio nos dois trechos
+    const auto& low  = data.front();
+    const auto& high = data.back();
+    auto [As, Ts]    = foam_sutherland_fit(sol, k);
+
+    out << "\n" << name << "\n{\n    specie\n    {\n"
+        << "        molWeight       " << gas->molecularWeight(k) << ";\n    }\n"
+        << "    thermodynamics\n    {\n"
+        << "        Tlow            " << ranges.front() << ";\n"
+        << "        Thigh           " << ranges.back() << ";\n"
+        << "        Tcommon         " << (ranges.size() > 2 ? ranges[1] : ranges.back()) << ";\n"
+        << "        highCpCoeffs    (";
+    for (auto c : high) {
+      out << " " << c;
+    }
+    out << " );\n        lowCpCoeffs     (";
+    for (auto c : low) {
+      out << " " << c;
+    }
+    out << " );\n    }\n    transport\n    {\n"
+        << "        As              " << As << ";\n"
+        << "        Ts              " << Ts << ";\n    }\n"
+        << "    elements\n    {\n";
+    for (const auto& [element, count] : sp->composition) {
+      out << "        " << element << "  " << count << ";\n";
+    }
+    out << "    }\n}\n";
+  }
+  out << foam_footer;
+}
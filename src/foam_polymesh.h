@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "channel_mesh.h"
+#include "foam_format.h"
+
+// Escreve a malha estruturada do channel_mesh direto em constant/polyMesh (points, faces, owner,
+// neighbour, boundary e cellZones), no formato binário do OpenFOAM, dispensando blockMesh e
+// createZones.
+//
+// Mesma malha que o blockMesh gera a partir do blockMeshDict do channel_mesh: células na ordem do
+// blockMesh (bloco a bloco, i mais rápido), pontos coincidentes entre blocos unidos (mergeType
+// points), faces internas em ordem triangular superior (dono crescente, depois vizinho crescente) e
+// faces de contorno agrupadas por patch. As faces seguem o modelo hex do OpenFOAM (normal para fora
+// da célula dona).
+
+struct foam_cell_zone {
+  std::string name;
+  std::vector<int32_t> cells;
+};
+
+namespace foam_polymesh_detail {
+
+// Faces do modelo hex em termos dos vértices locais 0..7 (normal para fora)
+constexpr int hex_faces[6][4] = {
+    {0, 4, 7, 3},  // x-
+    {1, 2, 6, 5},  // x+
+    {0, 1, 5, 4},  // y-
+    {3, 7, 6, 2},  // y+
+    {0, 3, 2, 1},  // z-
+    {4, 5, 6, 7},  // z+
+};
+
+struct face_key_hash {
+  size_t operator()(const std::array<int32_t, 4>& key) const {
+    size_t h = 0;
+    for (auto v : key) {
+      h = h * 1000003u ^ static_cast<size_t>(v);
+    }
+    return h;
+  }
+};
+
+std::array<int32_t, 4> sortedKey(std::array<int32_t, 4> face) {
+  std::sort(face.begin(), face.end());
+  return face;
+}
+
+std::string header(const std::string& format, const std::string& cls, const std::string& object,
+                   const std::string& note = "") {
+  std::string text =
+      "FoamFile\n{\n    format      " + format + ";\n" +
+      (format == "binary" ? "    arch        \"LSB;label=32;scalar=64\";\n" : "") +
+      "    class       " + cls + ";\n" + (note.empty() ? "" : "    note        \"" + note + "\";\n") +
+      "    location    \"constant/polyMesh\";\n    object      " + object + ";\n}\n\n";
+  return text;
+}
+
+template <typename T>
+void writeBinaryList(std::ofstream& out, const std::vector<T>& values) {
+  out << values.size() << "\n(";
+  out.write(reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+  out << ")\n";
+}
+
+std::ofstream openFile(const std::filesystem::path& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    throw std::runtime_error("foam_polymesh: não foi possível escrever " + path.string());
+  }
+  return out;
+}
+
+}  // namespace foam_polymesh_detail
+
+// Escreve a malha em polyMeshDir (ex.: <caso>/constant/polyMesh). scale converte as coordenadas dos
+// vértices para metros (convertToMeters do blockMeshDict).
+void write_foam_polymesh(const channel_mesh& mesh,
+                         const std::filesystem::path& polyMeshDir,
+                         const std::vector<foam_cell_zone>& zones = {},
+                         double scale = 0.001) {
+  using namespace foam_polymesh_detail;
+
+  // ===== Pontos: nós de cada bloco, unindo os que caem sobre faces compartilhadas =====
+  std::vector<double> points;  // x, y, z intercalados
+  std::vector<std::vector<int32_t>> block_nodes(mesh.blocks.size());
+
+  // Nós em faces de bloco são procurados em uma grade de tolerância (e nas 26 vizinhas, para não
+  // separar pontos que caem em lados opostos de um arredondamento)
+  double tolerance = 1e-6;
+  std::unordered_map<std::array<int32_t, 4>, int32_t, face_key_hash> merge;
+  auto bucket = [&](const std::array<double, 3>& p) {
+    return std::array<int32_t, 4>{static_cast<int32_t>(std::floor(p[0] / tolerance)),
+                                  static_cast<int32_t>(std::floor(p[1] / tolerance)),
+                                  static_cast<int32_t>(std::floor(p[2] / tolerance)),
+                                  0};
+  };
+  auto addPoint = [&](const std::array<double, 3>& p, bool shared) {
+    if (shared) {
+      auto b = bucket(p);
+      for (int dx = -1; dx <= 1; dx++) {
+        for (int dy = -1; dy <= 1; dy++) {
+          for (int dz = -1; dz <= 1; dz++) {
+            auto it = merge.find({b[0] + dx, b[1] + dy, b[2] + dz, 0});
+            if (it != merge.end()) {
+              const double* q = &points[3 * static_cast<size_t>(it->second)];
+              if (std::abs(q[0] - p[0]) < tolerance && std::abs(q[1] - p[1]) < tolerance &&
+                  std::abs(q[2] - p[2]) < tolerance) {
+                return it->second;
+              }
+            }
+          }
+        }
+      }
+    }
+    auto label = static_cast<int32_t>(points.size() / 3);
+    points.insert(points.end(), p.begin(), p.end());
+    if (shared) {
+      merge.emplace(bucket(p), label);
+    }
+    return label;
+  };
+
+  for (size_t b = 0; b < mesh.blocks.size(); b++) {
+    const auto& block = mesh.blocks[b];
+    auto [nx, ny, nz] = block.cells;
+    auto& nodes       = block_nodes[b];
+    nodes.resize(static_cast<size_t>(nx + 1) * (ny + 1) * (nz + 1));
+    for (int k = 0; k <= nz; k++) {
+      double u = channel_mesh::nodePosition(block, 2, k);
+      for (int j = 0; j <= ny; j++) {
+        double t = channel_mesh::nodePosition(block, 1, j);
+        for (int i = 0; i <= nx; i++) {
+          double s    = channel_mesh::nodePosition(block, 0, i);
+          bool shared = i == 0 || i == nx || j == 0 || j == ny || k == 0 || k == nz;
+          nodes[(static_cast<size_t>(k) * (ny + 1) + j) * (nx + 1) + i] =
+              addPoint(mesh.blockPoint(block, s, t, u), shared);
+        }
+      }
+    }
+  }
+  merge.clear();
+  for (auto& coordinate : points) {
+    coordinate *= scale;
+  }
+
+  // ===== Faces =====
+  struct internal_face {
+    int32_t owner;
+    int32_t neighbour;
+    std::array<int32_t, 4> points;
+  };
+  struct open_face {
+    int32_t owner;
+    int block;
+    int side;  // Índice em hex_faces
+    std::array<int32_t, 4> points;
+  };
+  std::vector<internal_face> internal;
+  std::unordered_map<std::array<int32_t, 4>, open_face, face_key_hash> open;
+
+  int32_t cell_offset = 0;
+  for (size_t b = 0; b < mesh.blocks.size(); b++) {
+    auto [nx, ny, nz] = mesh.blocks[b].cells;
+    const auto& nodes = block_nodes[b];
+    auto node         = [&](int i, int j, int k) {
+      return nodes[(static_cast<size_t>(k) * (ny + 1) + j) * (nx + 1) + i];
+    };
+    auto cellIndex = [&](int i, int j, int k) { return cell_offset + (k * ny + j) * nx + i; };
+
+    for (int k = 0; k < nz; k++) {
+      for (int j = 0; j < ny; j++) {
+        for (int i = 0; i < nx; i++) {
+          int32_t cell               = cellIndex(i, j, k);
+          std::array<int32_t, 8> hex = {node(i, j, k),
+                                        node(i + 1, j, k),
+                                        node(i + 1, j + 1, k),
+                                        node(i, j + 1, k),
+                                        node(i, j, k + 1),
+                                        node(i + 1, j, k + 1),
+                                        node(i + 1, j + 1, k + 1),
+                                        node(i, j + 1, k + 1)};
+          // Vizinho dentro do mesmo bloco para cada lado, -1 se o lado está na face do bloco
+          std::array<int32_t, 6> inside = {i > 0 ? cellIndex(i - 1, j, k) : -1,
+                                           i < nx - 1 ? cellIndex(i + 1, j, k) : -1,
+                                           j > 0 ? cellIndex(i, j - 1, k) : -1,
+                                           j < ny - 1 ? cellIndex(i, j + 1, k) : -1,
+                                           k > 0 ? cellIndex(i, j, k - 1) : -1,
+                                           k < nz - 1 ? cellIndex(i, j, k + 1) : -1};
+
+          for (int side = 0; side < 6; side++) {
+            std::array<int32_t, 4> face = {hex[hex_faces[side][0]],
+                                           hex[hex_faces[side][1]],
+                                           hex[hex_faces[side][2]],
+                                           hex[hex_faces[side][3]]};
+            if (inside[side] >= 0) {
+              if (inside[side] > cell) {
+                internal.push_back({cell, inside[side], face});
+              }
+              continue;
+            }
+            // Face de bloco: interna se outro bloco (já visitado, logo de índice menor) a tem
+            auto key = sortedKey(face);
+            auto it  = open.find(key);
+            if (it != open.end()) {
+              internal.push_back({it->second.owner, cell, it->second.points});
+              open.erase(it);
+            } else {
+              open.emplace(key, open_face{cell, static_cast<int>(b), side, face});
+            }
+          }
+        }
+      }
+    }
+    cell_offset += nx * ny * nz;
+  }
+  const int32_t n_cells = cell_offset;
+
+  std::sort(internal.begin(), internal.end(), [](const auto& a, const auto& b) {
+    return a.owner != b.owner ? a.owner < b.owner : a.neighbour < b.neighbour;
+  });
+
+  // Faces de contorno: patch pelo conjunto de vértices da face do bloco
+  std::map<std::array<int32_t, 4>, size_t> patch_of_face;
+  for (size_t p = 0; p < mesh.patches.size(); p++) {
+    for (const auto& face : mesh.patches[p].faces) {
+      patch_of_face[sortedKey({face[0], face[1], face[2], face[3]})] = p;
+    }
+  }
+  const size_t default_patch = mesh.patches.size();  // defaultFaces
+  std::vector<std::vector<open_face>> patch_faces(mesh.patches.size() + 1);
+  for (auto& [key, face] : open) {
+    const auto& v = mesh.blocks[face.block].vertices;
+    const auto& f = hex_faces[face.side];
+    auto it       = patch_of_face.find(sortedKey({v[f[0]], v[f[1]], v[f[2]], v[f[3]]}));
+    patch_faces[it == patch_of_face.end() ? default_patch : it->second].push_back(face);
+  }
+  open.clear();
+  for (auto& faces : patch_faces) {
+    std::sort(faces.begin(), faces.end(), [](const auto& a, const auto& b) {
+      return a.owner != b.owner ? a.owner < b.owner : a.side < b.side;
+    });
+  }
+
+  // ===== Arrays finais =====
+  std::vector<int32_t> offsets = {0};
+  std::vector<int32_t> labels;
+  std::vector<int32_t> owner;
+  std::vector<int32_t> neighbour;
+  size_t n_faces = internal.size();
+  for (const auto& faces : patch_faces) {
+    n_faces += faces.size();
+  }
+  offsets.reserve(n_faces + 1);
+  labels.reserve(4 * n_faces);
+  owner.reserve(n_faces);
+  neighbour.reserve(internal.size());
+
+  auto addFace = [&](const std::array<int32_t, 4>& face, int32_t face_owner) {
+    labels.insert(labels.end(), face.begin(), face.end());
+    offsets.push_back(static_cast<int32_t>(labels.size()));
+    owner.push_back(face_owner);
+  };
+  for (const auto& face : internal) {
+    addFace(face.points, face.owner);
+    neighbour.push_back(face.neighbour);
+  }
+  std::vector<std::pair<size_t, size_t>> patch_ranges;  // (startFace, nFaces)
+  for (const auto& faces : patch_faces) {
+    patch_ranges.emplace_back(owner.size(), faces.size());
+    for (const auto& face : faces) {
+      addFace(face.points, face.owner);
+    }
+  }
+
+  // ===== Escrita =====
+  std::filesystem::create_directories(polyMeshDir);
+  std::string note = "nPoints:" + std::to_string(points.size() / 3) +
+                     "  nCells:" + std::to_string(n_cells) + "  nFaces:" + std::to_string(n_faces) +
+                     "  nInternalFaces:" + std::to_string(internal.size());
+  {
+    auto out = openFile(polyMeshDir / "points");
+    out << foam_banner << header("binary", "vectorField", "points");
+    out << points.size() / 3 << "\n(";
+    out.write(reinterpret_cast<const char*>(points.data()),
+              static_cast<std::streamsize>(points.size() * sizeof(double)));
+    out << ")\n" << foam_footer;
+  }
+  {
+    auto out = openFile(polyMeshDir / "faces");
+    out << foam_banner << header("binary", "faceCompactList", "faces");
+    writeBinaryList(out, offsets);
+    writeBinaryList(out, labels);
+    out << foam_footer;
+  }
+  {
+    auto out = openFile(polyMeshDir / "owner");
+    out << foam_banner << header("binary", "labelList", "owner", note);
+    writeBinaryList(out, owner);
+    out << foam_footer;
+  }
+  {
+    auto out = openFile(polyMeshDir / "neighbour");
+    out << foam_banner << header("binary", "labelList", "neighbour", note);
+    writeBinaryList(out, neighbour);
+    out << foam_footer;
+  }
+  {
+    auto out = openFile(polyMeshDir / "boundary");
+    out << foam_banner << header("ascii", "polyBoundaryMesh", "boundary");
+    size_t n_patches = mesh.patches.size() + (patch_faces[default_patch].empty() ? 0 : 1);
+    out << n_patches << "\n(\n";
+    for (size_t p = 0; p < n_patches; p++) {
+      std::string name = p < mesh.patches.size() ? mesh.patches[p].name : "defaultFaces";
+      std::string type = p < mesh.patches.size() ? mesh.patches[p].type : "empty";
+      out << "    " << name << "\n    {\n        type            " << type << ";\n";
+      if (type != "patch") {
+        out << "        inGroups        List<word> 1(" << type << ");\n";
+      }
+      out << "        nFaces          " << patch_ranges[p].second << ";\n"
+          << "        startFace       " << patch_ranges[p].first << ";\n    }\n";
+    }
+    out << ")\n" << foam_footer;
+  }
+  {
+    auto out = openFile(polyMeshDir / "cellZones");
+    out << foam_banner << header("ascii", "regIOobject", "cellZones");
+    out << zones.size() << "\n(\n";
+    for (const auto& zone : zones) {
+      out << zone.name << "\n{\n    type cellZone;\ncellLabels      List<label> " << zone.cells.size()
+          << "\n(\n";
+      for (auto cell : zone.cells) {
+        out << cell << "\n";
+      }
+      out << ")\n;\n}\n";
+    }
+    out << ")\n" << foam_footer;
+  }
+}
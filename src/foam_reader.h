@@ -0,0 +1,331 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Leitura direta de malhas (constant/polyMesh) e campos (<tempo>/T, U, ...) do OpenFOAM, em ASCII ou
+// binário, sem passar pelo ParaView. Os arquivos são mapeados em memória (mmap); se o mapeamento
+// falhar, são lidos inteiros. Arquivos comprimidos (.gz) não são suportados: use writeCompression off.
+
+// Arquivo mapeado em memória (somente leitura)
+class mapped_file {
+ public:
+  explicit mapped_file(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("foam_reader: não foi possível abrir " + path.string());
+    }
+    struct stat info {};
+    ::fstat(fd, &info);
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0) {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+      }
+    }
+    ::close(fd);
+    if (data_ == nullptr && size_ > 0) {
+      std::ifstream in(path, std::ios::binary);
+      buffer_.resize(size_);
+      in.read(buffer_.data(), static_cast<std::streamsize>(size_));
+    }
+  }
+  ~mapped_file() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+  mapped_file(const mapped_file&)            = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  std::string_view view() const {
+    return data_ != nullptr ? std::string_view(data_, size_) : std::string_view(buffer_);
+  }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_      = 0;
+  std::string buffer_;
+};
+
+// Cursor sobre o conteúdo de um arquivo do OpenFOAM
+class foam_parser {
+ public:
+  foam_parser(std::string_view text, const std::string& name) : text_(text), name_(name) {
+    // Cabeçalho FoamFile: formato e tamanho do label
+    size_t header = text_.find("FoamFile");
+    if (header == std::string_view::npos) {
+      fail("sem cabeçalho FoamFile");
+    }
+    size_t end  = text_.find('}', header);
+    auto dict   = text_.substr(header, end - header);
+    binary_     = dict.find("binary") != std::string_view::npos;
+    label_size_ = dict.find("label=64") != std::string_view::npos ? 8 : 4;
+    if (dict.find("scalar=32") != std::string_view::npos) {
+      fail("scalar de 32 bits não suportado");
+    }
+    pos_ = end + 1;
+  }
+
+  bool binary() const { return binary_; }
+
+  // Avança até logo depois da palavra-chave (ex.: "internalField")
+  void seek(std::string_view keyword) {
+    size_t at = text_.find(keyword, pos_);
+    if (at == std::string_view::npos) {
+      fail("palavra-chave " + std::string(keyword) + " não encontrada");
+    }
+    pos_ = at + keyword.size();
+  }
+
+  void skip() {
+    while (pos_ < text_.size()) {
+      char c = text_[pos_];
+      if (c == ' ' || c == '\n' || c == '\t' || c == '\r') {
+        pos_++;
+      } else if (text_.compare(pos_, 2, "//") == 0) {
+        size_t eol = text_.find('\n', pos_);
+        pos_       = eol == std::string_view::npos ? text_.size() : eol + 1;
+      } else if (text_.compare(pos_, 2, "/*") == 0) {
+        size_t close = text_.find("*/", pos_ + 2);
+        pos_         = close == std::string_view::npos ? text_.size() : close + 2;
+      } else {
+        break;
+      }
+    }
+  }
+
+  // Próxima palavra (letras, dígitos, '_', '<', '>')
+  std::string_view word() {
+    skip();
+    size_t start = pos_;
+    while (pos_ < text_.size() &&
+           (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_' ||
+            text_[pos_] == '<' || text_[pos_] == '>')) {
+      pos_++;
+    }
+    return text_.substr(start, pos_ - start);
+  }
+
+  void expect(char c) {
+    skip();
+    if (pos_ >= text_.size() || text_[pos_] != c) {
+      fail(std::string("esperado '") + c + "'");
+    }
+    pos_++;
+  }
+
+  template <typename T>
+  T number() {
+    // Parênteses são separadores nas listas ASCII ("4(0 1 2 3)", "(1 0 0)")
+    for (skip(); pos_ < text_.size() && (text_[pos_] == '(' || text_[pos_] == ')'); skip()) {
+      pos_++;
+    }
+    T value{};
+    auto [ptr, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+    if (ec != std::errc()) {
+      fail("número esperado");
+    }
+    pos_ = static_cast<size_t>(ptr - text_.data());
+    return value;
+  }
+
+  // Lista de labels "N ( ... )" (ASCII ou binária)
+  std::vector<int64_t> labelList() {
+    auto n = static_cast<size_t>(number<int64_t>());
+    std::vector<int64_t> values(n);
+    if (binary_) {
+      const char* raw = rawBlock(n * label_size_);
+      for (size_t i = 0; i < n; i++) {
+        if (label_size_ == 4) {
+          int32_t v;
+          std::memcpy(&v, raw + 4 * i, 4);
+          values[i] = v;
+        } else {
+          std::memcpy(&values[i], raw + 8 * i, 8);
+        }
+      }
+    } else {
+      expect('(');
+      for (auto& v : values) {
+        v = number<int64_t>();
+      }
+      expect(')');
+    }
+    return values;
+  }
+
+  // Lista de escalares (components = 1) ou vetores (components = 3), intercalados
+  std::vector<double> scalarList(size_t components) {
+    auto n = static_cast<size_t>(number<int64_t>());
+    std::vector<double> values(n * components);
+    if (binary_) {
+      std::memcpy(values.data(), rawBlock(values.size() * sizeof(double)),
+                  values.size() * sizeof(double));
+    } else {
+      expect('(');
+      for (auto& v : values) {
+        v = number<double>();
+      }
+      skip();
+      while (pos_ < text_.size() && text_[pos_] == ')') {
+        pos_++;
+        skip();
+      }
+    }
+    return values;
+  }
+
+  [[noreturn]] void fail(const std::string& message) const {
+    throw std::runtime_error("foam_reader: " + name_ + ": " + message);
+  }
+
+ private:
+  std::string_view text_;
+  std::string name_;
+  size_t pos_        = 0;
+  bool binary_       = false;
+  size_t label_size_ = 4;
+
+  const char* rawBlock(size_t bytes) {
+    expect('(');
+    if (pos_ + bytes > text_.size()) {
+      fail("lista binária truncada");
+    }
+    const char* raw = text_.data() + pos_;
+    pos_ += bytes;
+    expect(')');
+    return raw;
+  }
+};
+
+struct foam_mesh {
+  std::vector<double> points;  // x, y, z intercalados
+  std::vector<std::vector<int64_t>> faces;
+  std::vector<int64_t> owner;
+  std::vector<int64_t> neighbour;
+  size_t n_cells = 0;
+
+  // Centro aproximado de cada célula: média dos centros das faces (exato para hexaedros regulares)
+  std::vector<std::array<double, 3>> cellCentres() const {
+    std::vector<std::array<double, 3>> centres(n_cells, {0.0, 0.0, 0.0});
+    std::vector<int> count(n_cells, 0);
+    for (size_t f = 0; f < faces.size(); f++) {
+      std::array<double, 3> centre{0.0, 0.0, 0.0};
+      for (auto p : faces[f]) {
+        for (int d = 0; d < 3; d++) {
+          centre[d] += points[3 * static_cast<size_t>(p) + d];
+        }
+      }
+      for (auto cell : {f < neighbour.size() ? neighbour[f] : -1, owner[f]}) {
+        if (cell < 0) {
+          continue;
+        }
+        for (int d = 0; d < 3; d++) {
+          centres[cell][d] += centre[d] / static_cast<double>(faces[f].size());
+        }
+        count[cell]++;
+      }
+    }
+    for (size_t c = 0; c < n_cells; c++) {
+      for (int d = 0; d < 3; d++) {
+        centres[c][d] /= std::max(count[c], 1);
+      }
+    }
+    return centres;
+  }
+};
+
+foam_mesh read_foam_mesh(const std::filesystem::path& polyMeshDir) {
+  foam_mesh mesh;
+  {
+    mapped_file file(polyMeshDir / "points");
+    foam_parser parser(file.view(), "points");
+    mesh.points = parser.scalarList(3);
+  }
+  {
+    mapped_file file(polyMeshDir / "faces");
+    foam_parser parser(file.view(), "faces");
+    if (file.view().find("faceCompactList") != std::string_view::npos) {
+      auto offsets = parser.labelList();
+      auto labels  = parser.labelList();
+      mesh.faces.resize(offsets.empty() ? 0 : offsets.size() - 1);
+      for (size_t f = 0; f < mesh.faces.size(); f++) {
+        mesh.faces[f].assign(labels.begin() + offsets[f], labels.begin() + offsets[f + 1]);
+      }
+    } else {
+      auto n = static_cast<size_t>(parser.number<int64_t>());
+      parser.expect('(');
+      mesh.faces.resize(n);
+      for (auto& face : mesh.faces) {
+        face.resize(static_cast<size_t>(parser.number<int64_t>()));
+        for (auto& p : face) {
+          p = parser.number<int64_t>();
+        }
+      }
+    }
+  }
+  {
+    mapped_file file(polyMeshDir / "owner");
+    mesh.owner = foam_parser(file.view(), "owner").labelList();
+  }
+  {
+    mapped_file file(polyMeshDir / "neighbour");
+    mesh.neighbour = foam_parser(file.view(), "neighbour").labelList();
+  }
+  for (auto cell : mesh.owner) {
+    mesh.n_cells = std::max(mesh.n_cells, static_cast<size_t>(cell + 1));
+  }
+  for (auto cell : mesh.neighbour) {
+    mesh.n_cells = std::max(mesh.n_cells, static_cast<size_t>(cell + 1));
+  }
+  return mesh;
+}
+
+// internalField de um volScalarField (components = 1) ou volVectorField (components = 3),
+// expandido para n_cells valores se for uniforme
+std::vector<double> read_foam_field(const std::filesystem::path& path,
+                                    size_t components,
+                                    size_t n_cells) {
+  mapped_file file(path);
+  foam_parser parser(file.view(), path.filename().string());
+  parser.seek("internalField");
+  auto kind = parser.word();
+  if (kind == "uniform") {
+    std::vector<double> value(components);
+    for (auto& v : value) {
+      v = parser.number<double>();
+    }
+    std::vector<double> values(n_cells * components);
+    for (size_t c = 0; c < n_cells; c++) {
+      std::copy(value.begin(), value.end(), values.begin() + c * components);
+    }
+    return values;
+  }
+  if (kind != "nonuniform") {
+    parser.fail("internalField inválido");
+  }
+  parser.word();  // List<scalar> / List<vector>
+  auto values = parser.scalarList(components);
+  if (values.size() != n_cells * components) {
+    parser.fail("número de valores diferente do número de células");
+  }
+  return values;
+}
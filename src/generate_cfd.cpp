@@ -1,70 +1,263 @@
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdlib>  // Necessário para std::getenv
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <optional>
+#include <set>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/stringUtils.h"
+#include "cantera/kinetics/Reaction.h"
+#include "cantera/oneD/DomainFactory.h"
+#include "cantera/onedim.h"
+#include "cantera/thermo/Species.h"
+#include "cantera/transport/TransportData.h"
+#include "case_template.h"
+#include "channel_mesh.h"
+#include "foam_decomposition.h"
+#include "foam_mechanism.h"
+#include "foam_polymesh.h"
+#include "lib.h"
+#include "parallel.h"
+
+// internalField não uniforme (escalar ou vetor (x 0 0)) para os arquivos de 0/
+std::string nonuniformField(const std::vector<double>& values, bool vector = false) {
+  std::ostringstream out;
+  out.precision(8);
+  out << "nonuniform List<" << (vector ? "vector" : "scalar") << ">\n"
+      << values.size() << "\n(\n";
+  for (auto v : values) {
+    if (vector) {
+      out << "(" << v << " 0 0)\n";
+    } else {
+      out << v << "\n";
+    }
+  }
+  out << ")\n";
+  return out.str();
+}
 
-// Função auxiliar para substituir variáveis em um arquivo
-void replaceInFile(const std::string& filePath,
-                   const std::map<std::string, std::string>& replacements) {
-  std::ifstream inputFile(filePath);
-  if (!inputFile.is_open()) {
-    std::cerr << "Erro: Não foi possível abrir o arquivo: " << filePath << std::endl;
-    return;
+// Interpolação linear de um perfil 1-D, constante fora do intervalo
+double interpolateProfile(const std::vector<double>& z, const std::vector<double>& values, double x) {
+  if (x <= z.front()) {
+    return values.front();
+  }
+  if (x >= z.back()) {
+    return values.back();
   }
+  size_t i = std::upper_bound(z.begin(), z.end(), x) - z.begin();
+  double w = (x - z[i - 1]) / (z[i] - z[i - 1]);
+  return values[i - 1] + w * (values[i] - values[i - 1]);
+}
 
+// Lista "species ( ... );" de um thermo.compressibleGas
+std::vector<std::string> readFoamSpeciesList(const std::string& filePath) {
+  std::ifstream inputFile(filePath);
   std::string content((std::istreambuf_iterator<char>(inputFile)),
                       std::istreambuf_iterator<char>());
-  inputFile.close();
 
-  for (const auto& [placeholder, value] : replacements) {
-    size_t pos = 0;
-    while ((pos = content.find(placeholder, pos)) != std::string::npos) {
-      content.replace(pos, placeholder.length(), value);
-      pos += value.length();
-    }
+  std::vector<std::string> species;
+  size_t begin = content.find('(', content.find("species"));
+  size_t end   = content.find(')', begin);
+  if (begin == std::string::npos || end == std::string::npos) {
+    return species;
   }
+  std::istringstream list(content.substr(begin + 1, end - begin - 1));
+  std::string name;
+  while (list >> name) {
+    species.push_back(name);
+  }
+  return species;
+}
 
-  std::ofstream outputFile(filePath);
-  if (!outputFile.is_open()) {
-    std::cerr << "Erro: Não foi possível escrever no arquivo: " << filePath << std::endl;
-    return;
+// Parâmetros de um caso. Os valores padrão são os do canal de referência; uma campanha
+// (--campaign) varia qualquer um dos campos numéricos pelo nome.
+struct case_parameters {
+  double height_channel     = 2.0;    // mm (Altura do canal)
+  double length_inlet       = 37.0;   // mm (Comprimento entrada)
+  double length_expansion   = 110.0;  // mm (Comprimento expansão)
+  double width_inlet        = 25.0;   // mm (Largura entrada)
+  double width_expansion    = 63.2;   // mm (Largura expansão/saída)
+
+  double channel_thickness  = 2.0;    // mm (Espessura do canal)
+
+  double length_extern      = 50.0;   // mm (Comprimento sobressalente)
+  double width_extern       = 6.0;    // mm (Largura sobressalente adicional)
+  double height_extern      = 6.0;    // mm (Altura sobressalente adicional)
+
+  // Tamanho máximo e mínimo de célula em cada direção (mm)
+  double max_cell_size_x    = 0.5;
+  double max_cell_size_y    = 1.0;
+  double max_cell_size_z    = 1.0;
+
+  // Mínimos ajustados para evitar células muito finas
+  double min_cell_size_x    = 0.5;
+  double min_cell_size_y    = 0.5;  // (camada limite, mais seguro)
+  double min_cell_size_z    = 0.5;
+
+  // Fator aplicado a todos os tamanhos de célula acima (família de malhas do estudo de convergência)
+  double mesh_scale         = 1.0;
+
+  // Com --meshFamily: mesh_scale da malha mais grossa da família (0 fora dela). As contagens de
+  // células saem dessa malha multiplicadas pela razão de refinamento, em todas as direções.
+  double mesh_family_coarsest = 0.0;
+
+  // Com --refineFlame: max_cell_size_x só na faixa da chama, crescendo até coarse_cell_size_x fora
+  double coarse_cell_size_x = 2.0;   // mm
+  double growth_cell_size_x = 0.1;   // Aumento do tamanho de célula por mm de distância da faixa
+  double flame_band_margin  = 10.0;  // mm (meia largura mínima da faixa, cobre o erro da estimativa)
+
+  double velocity_inlet     = 0.5;              // m/s (Velocidade de entrada)
+  double temperature_inlet  = 293.0;            // K
+  double pressure           = Cantera::OneBar;  // Pa (1 bar, como em 0/p)
+
+  // Decomposição: número de subdomínios = células / cells_per_core, até max_cores (0 = todos os
+  // núcleos desta máquina)
+  double cells_per_core     = 30000.0;
+  unsigned max_cores        = 0;
+
+  // Mecanismo do Cantera a exportar para o caso (ex.: output/modified_mechanism.yaml). Vazio mantém
+  // constant/reactions e constant/thermo.compressibleGas do template.
+  std::string mechanism_path;
+  // Inicializa T, U e Y a partir de uma chama 1-D, sem fase fria nem ignição
+  bool init_flame   = false;
+  // Refina a malha em x apenas na faixa da chama prevista pela chama 1-D, engrossando no resto
+  bool refine_flame = false;
+  // Escreve constant/polyMesh (com a ignitionZone) direto, sem blockMesh/createZones no buildrun.sh
+  bool write_polymesh = false;
+};
+
+static const std::map<std::string, double case_parameters::*> case_parameter_fields = {
+    {"height_channel", &case_parameters::height_channel},
+    {"length_inlet", &case_parameters::length_inlet},
+    {"length_expansion", &case_parameters::length_expansion},
+    {"width_inlet", &case_parameters::width_inlet},
+    {"width_expansion", &case_parameters::width_expansion},
+    {"channel_thickness", &case_parameters::channel_thickness},
+    {"length_extern", &case_parameters::length_extern},
+    {"width_extern", &case_parameters::width_extern},
+    {"height_extern", &case_parameters::height_extern},
+    {"max_cell_size_x", &case_parameters::max_cell_size_x},
+    {"max_cell_size_y", &case_parameters::max_cell_size_y},
+    {"max_cell_size_z", &case_parameters::max_cell_size_z},
+    {"min_cell_size_x", &case_parameters::min_cell_size_x},
+    {"min_cell_size_y", &case_parameters::min_cell_size_y},
+    {"min_cell_size_z", &case_parameters::min_cell_size_z},
+    {"mesh_scale", &case_parameters::mesh_scale},
+    {"coarse_cell_size_x", &case_parameters::coarse_cell_size_x},
+    {"growth_cell_size_x", &case_parameters::growth_cell_size_x},
+    {"flame_band_margin", &case_parameters::flame_band_margin},
+    {"velocity_inlet", &case_parameters::velocity_inlet},
+    {"temperature_inlet", &case_parameters::temperature_inlet},
+    {"pressure", &case_parameters::pressure},
+    {"cells_per_core", &case_parameters::cells_per_core},
+};
+
+// Resumo de um caso gerado, para o manifesto da campanha
+struct case_summary {
+  long n_cells     = 0;
+  int n_subdomains = 1;
+  std::array<long, 3> cells_xyz = {0, 0, 0};  // Células ao longo de x, y e z (mesh_extent_cells)
+};
+
+// Arquivo de campanha: uma linha "parametro = v1 v2 ..." por parâmetro variado ('#' comenta).
+// Gera o produto cartesiano de todos os valores.
+std::vector<std::pair<std::string, std::vector<double>>> readCampaign(const std::string& filePath) {
+  std::ifstream inputFile(filePath);
+  if (!inputFile.is_open()) {
+    throw std::runtime_error("não foi possível abrir a campanha " + filePath);
   }
 
-  outputFile << content;
-  outputFile.close();
+  std::vector<std::pair<std::string, std::vector<double>>> axes;
+  std::string line;
+  while (std::getline(inputFile, line)) {
+    line = line.substr(0, line.find('#'));
+    size_t equal = line.find('=');
+    if (equal == std::string::npos) {
+      if (line.find_first_not_of(" \t\r") != std::string::npos) {
+        throw std::runtime_error("linha inválida na campanha: " + line);
+      }
+      continue;
+    }
+    std::istringstream name_stream(line.substr(0, equal));
+    std::istringstream value_stream(line.substr(equal + 1));
+    std::string name;
+    name_stream >> name;
+    if (!case_parameter_fields.count(name)) {
+      throw std::runtime_error("parâmetro desconhecido na campanha: " + name);
+    }
+    std::vector<double> values;
+    for (double v; value_stream >> v;) {
+      values.push_back(v);
+    }
+    if (values.empty()) {
+      throw std::runtime_error("parâmetro sem valores na campanha: " + name);
+    }
+    axes.emplace_back(name, values);
+  }
+  return axes;
 }
 
-int main(int argc, char** argv) {
-  auto height_channel      = 2.0;    // mm (Altura do canal)
-  auto length_inlet        = 37.0;   // mm (Comprimento entrada)
-  auto length_expansion    = 110.0;  // mm (Comprimento expansão)
-  auto width_inlet         = 25.0;   // mm (Largura entrada)
-  auto width_expansion     = 63.2;   // mm (Largura expansão/saída)
+// Gera um caso completo em dirPath a partir do template. Retorna 0 em caso de sucesso; summary
+// recebe o número de células previsto da malha e o número de subdomínios escolhido.
+int generate_case(const case_parameters& params,
+                  const case_template& templ,
+                  const std::string& dirPath,
+                  case_summary* summary = nullptr) {
+  auto height_channel      = params.height_channel;
+  auto length_inlet        = params.length_inlet;
+  auto length_expansion    = params.length_expansion;
+  auto width_inlet         = params.width_inlet;
+  auto width_expansion     = params.width_expansion;
   auto height_channel_half = height_channel * 0.5;
 
-  auto channel_thickness   = 2.0;  // mm (Espessura do canal
+  auto channel_thickness   = params.channel_thickness;
 
-  auto length_extern       = 50.0;  // mm (Comprimento sobressalente)
-  auto width_extern        = 6.0;   // mm (Largura sobressalente adicional)
-  auto height_extern       = 6.0;   // mm (Altura sobressalente adicional)
+  auto length_extern       = params.length_extern;
+  auto width_extern        = params.width_extern;
+  auto height_extern       = params.height_extern;
 
-  // Defina o tamanho máximo e mínimo de célula em cada direção (mm)
-  auto max_cell_size_x = 0.5; // mm
-  auto max_cell_size_y = 1.0; // mm
-  auto max_cell_size_z = 1.0; // mm
+  auto max_cell_size_x     = params.max_cell_size_x * params.mesh_scale;
+  auto max_cell_size_y     = params.max_cell_size_y * params.mesh_scale;
+  auto max_cell_size_z     = params.max_cell_size_z * params.mesh_scale;
 
-  // Mínimos ajustados para evitar células muito finas
-  auto min_cell_size_x  = 0.5;  // mm
-  auto min_cell_size_y  = 0.5;  // mm (camada limite, mais seguro)
-  auto min_cell_size_z  = 0.5;  // mm
+  auto min_cell_size_x     = params.min_cell_size_x * params.mesh_scale;
+  auto min_cell_size_y     = params.min_cell_size_y * params.mesh_scale;
+  auto min_cell_size_z     = params.min_cell_size_z * params.mesh_scale;
+
+  auto coarse_cell_size_x  = params.coarse_cell_size_x * params.mesh_scale;
+  auto growth_cell_size_x  = params.growth_cell_size_x;
+  auto flame_band_margin   = params.flame_band_margin;
+
+  auto velocity_inlet      = params.velocity_inlet;
+  auto temperature_inlet   = params.temperature_inlet;
+  auto pressure            = params.pressure;
 
-  auto velocity_inlet   = 0.5;  // m/s (Velocidade de entrada)'
+  const auto& mechanism_path = params.mechanism_path;
+  bool init_flame            = params.init_flame;
+  bool refine_flame          = params.refine_flame;
 
   auto length_channel   = ((length_inlet + length_expansion) * 0.001);
 
+  std::map<std::string, double> initial_concentrations = {
+      {"CH4", 0.055},
+      {"N2", 0.724},
+      {"O2", 0.22},
+  };
+
+  std::map<std::string, double> external_concentrations = {
+      {"CH4", 0.0},
+      {"N2", 0.767},
+      {"O2", 0.233},
+  };
+
   auto velocity_average = velocity_inlet / 2.0;
   auto time_cold_flow   = length_channel / velocity_average;  // Tempo total de simulação (s)
 
@@ -73,14 +266,28 @@ int main(int argc, char** argv) {
   double position_ignition_flame_val = length_channel;  // + (length_extern * 0.001) / 2.0;
 
   auto time_simulation               = time_cold_flow + 2.0;  // Tempo total de simulação (s)
+  if (init_flame) {
+    // Já parte da chama queimando: basta ~um tempo de residência para ela se acomodar
+    time_simulation = length_channel / velocity_average;
+  }
+
+  // Família de malhas: calculadas direto em cada malha, as contagens pequenas (z, espessura, externo)
+  // ficariam presas no mínimo de 4 células e só x e y refinariam. Por isso a contagem vem da malha
+  // mais grossa e é multiplicada pela razão de refinamento; a razão de grading não muda.
+  const double refinement =
+      params.mesh_family_coarsest > 0.0 ? params.mesh_family_coarsest / params.mesh_scale : 1.0;
 
   // Função para calcular o número de células e razão de expansão dado L, target_max e target_min de
   // forma analítica
   auto calculateGradingAndCells =
-      [](double L, double dx_max, double dx_min) -> std::pair<int, double> {
+      [refinement](double L, double dx_max, double dx_min) -> std::pair<int, double> {
+    dx_max *= refinement;
+    dx_min *= refinement;
+    auto refine = [refinement](int N) { return static_cast<int>(std::round(N * refinement)); };
+
     if (std::abs(dx_max - dx_min) < 1e-6 || L <= std::max(dx_max, dx_min)) {
       int N = std::max(4, static_cast<int>(std::round(L / std::max(dx_max, dx_min))));
-      return {N, 1.0};
+      return {refine(N), 1.0};
     }
 
     // Cálculo analítico exato usando a progressão geométrica:
@@ -93,7 +300,7 @@ int main(int argc, char** argv) {
     // Calcula N e arredonda para o inteiro mais próximo
     int N = std::max(4, static_cast<int>(std::round(1.0 + std::log(target_ratio) / std::log(k))));
 
-    return {N, target_ratio};
+    return {refine(N), target_ratio};
   };
 
   // Uniform in X uses max_cell_size
@@ -120,323 +327,392 @@ int main(int argc, char** argv) {
   auto [n_cells_y_extern, _rye] =
       calculateGradingAndCells(width_extern, max_cell_size_y, max_cell_size_y);
 
-  std::string vertices[40] = {
-      "(0 0 " + std::to_string(-height_channel_half) + ")",  // Vertex 0
-      "(0 0 0)",                                             // Vertex 1
-      "(0 " + std::to_string(width_inlet / 2) + " " + std::to_string(-height_channel_half) +
-          ")",                                               // Vertex 2
-      "(0 " + std::to_string(width_inlet / 2) + " 0" + ")",  // Vertex 3
-      "(" + std::to_string(length_inlet) + " 0 " + std::to_string(-height_channel_half) +
-          ")",                                            // Vertex 4
-      "(" + std::to_string(length_inlet) + " 0 0" + ")",  // Vertex 5
-      "(" + std::to_string(length_inlet) + " " + std::to_string(width_inlet / 2) + " " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 6
-      "(" + std::to_string(length_inlet) + " " + std::to_string(width_inlet / 2) + " " + "0" +
-          ")",  // Vertex 7
-      "(" + std::to_string(length_inlet + length_expansion) + " 0 " +
-          std::to_string(-height_channel_half) + ")",                             // Vertex 8
-      "(" + std::to_string(length_inlet + length_expansion) + " 0 " + "0" + ")",  // Vertex 9
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2) + " " + std::to_string(-height_channel_half) +
-          ")",  // Vertex 10
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2) + " 0" + ")",  // Vertex 11
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " 0 " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 12
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " 0 " + "0" +
-          ")",  // Vertex 13
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2) + " " + std::to_string(-height_channel_half) +
-          ")",  // Vertex 14
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2) + " 0" + ")",  // Vertex 15
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 16
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " 0" +
-          ")",  // Vertex 17
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 18
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " 0" +
-          ")",  // Vertex 19
-      "(" + std::to_string(length_inlet + length_expansion) + " 0 " +
-          std::to_string(height_channel_half) + ")",  // Vertex 20
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2) + " " + std::to_string(height_channel_half) +
-          ")",  // Vertex 21
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " 0 " +
-          std::to_string(height_channel_half) + ")",  // Vertex 22
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2) + " " + std::to_string(height_channel_half) +
-          ")",  // Vertex 23
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(height_channel_half) + ")",  // Vertex 24
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(height_channel_half) + ")",  // Vertex 25
+  // Coordenadas características (mm)
+  const double x_inlet     = 0.0;
+  const double x_expansion = length_inlet;
+  const double x_outlet    = length_inlet + length_expansion;
+  const double x_extern    = length_inlet + length_expansion + length_extern;
+
+  const double y_inlet     = width_inlet / 2;
+  const double y_expansion = width_expansion / 2;
+  const double y_thickness = width_expansion / 2 + channel_thickness;
+  const double y_extern    = width_expansion * 0.5 + channel_thickness + width_extern;
+
+  const double z_lower     = -height_channel_half;
+  const double z_upper     = height_channel_half;
+  const double z_extern    = height_channel_half + height_extern;
+
+  // ===== Chama 1-D nas condições de entrada =====
+  // Usada para inicializar os campos (--initFlame) e para posicionar o refinamento (--refineFlame)
+  auto half_width = [&](double x) {
+    double f = std::clamp((x - x_expansion) / (x_outlet - x_expansion), 0.0, 1.0);
+    return y_inlet + f * (y_expansion - y_inlet);
+  };
+
+  thermo_state flame;
+  flame_profile profile;
+  double x_flame = x_outlet;  // mm
+  double z_mid   = 0.0;       // m, posição de referência no perfil 1-D
+  if (init_flame || refine_flame) {
+    auto fuel     = "CH4";
+    auto oxidizer = "O2:1, N2:3.76";  // Em massa: O2 0.233, N2 0.767 (ar externo)
+
+    auto sol = Cantera::newSolution(
+        mechanism_path.empty() ? "gri30.yaml" : mechanism_path, "", "mixture-averaged");
+    // Local: na campanha, generate_case roda em várias threads e flamespeed() escreve no mapa
+    std::multimap<std::string, std::pair<std::string, double>> reactions;
+    flame = flamespeed(sol,
+                       temperature_inlet,
+                       pressure,
+                       velocity_inlet,
+                       initial_concentrations["CH4"],  // Fração de mistura = Y_CH4 na entrada
+                       fuel,
+                       oxidizer,
+                       true,
+                       0,
+                       reactions,
+                       &profile);
+    if (flame.flamespeed <= 0.0 || profile.empty()) {
+      std::cerr << "Erro: Não foi possível resolver a chama 1-D." << std::endl;
+      return 1;
+    }
+
+    // Estabilização: no divergente a velocidade média cai com a largura, u(x) = U_in * W_in / W(x);
+    // a chama fica onde u(x) = S_L
+    double width_flame = velocity_inlet * y_inlet / flame.flamespeed;
+    x_flame            = x_expansion + (width_flame - y_inlet) / (y_expansion - y_inlet) *
+                                       (x_outlet - x_expansion);
+    if (x_flame < x_expansion || x_flame > x_outlet) {
+      std::cerr << "Aviso: S_L = " << flame.flamespeed
+                << " m/s não estabiliza no divergente; chama posicionada no limite." << std::endl;
+      x_flame = std::clamp(x_flame, x_expansion, x_outlet);
+    }
+
+    // Ponto do perfil 1-D em que T passa pela média entre queimado e não queimado
+    double T_mid = 0.5 * (profile.T.front() + profile.T.back());
+    z_mid        = profile.z.front();
+    for (size_t n = 1; n < profile.z.size(); n++) {
+      if (profile.T[n] >= T_mid) {
+        z_mid = interpolateProfile({profile.T[n - 1], profile.T[n]},
+                                   {profile.z[n - 1], profile.z[n]},
+                                   T_mid);
+        break;
+      }
+    }
+
+    std::cout << "Chama 1-D: S_L = " << flame.flamespeed << " m/s, Tad = " << flame.Tad
+              << " K, espessura = " << flame.thickness * 1000.0
+              << " mm, posição esperada x = " << x_flame << " mm" << std::endl;
+  }
+
+  channel_mesh mesh;
+  mesh.vertices = {
+      {x_inlet, 0, z_lower},                // Vertex 0
+      {x_inlet, 0, 0},                      // Vertex 1
+      {x_inlet, y_inlet, z_lower},          // Vertex 2
+      {x_inlet, y_inlet, 0},                // Vertex 3
+      {x_expansion, 0, z_lower},            // Vertex 4
+      {x_expansion, 0, 0},                  // Vertex 5
+      {x_expansion, y_inlet, z_lower},      // Vertex 6
+      {x_expansion, y_inlet, 0},            // Vertex 7
+      {x_outlet, 0, z_lower},               // Vertex 8
+      {x_outlet, 0, 0},                     // Vertex 9
+      {x_outlet, y_expansion, z_lower},     // Vertex 10
+      {x_outlet, y_expansion, 0},           // Vertex 11
+      {x_extern, 0, z_lower},               // Vertex 12
+      {x_extern, 0, 0},                     // Vertex 13
+      {x_extern, y_expansion, z_lower},     // Vertex 14
+      {x_extern, y_expansion, 0},           // Vertex 15
+      {x_outlet, y_extern, z_lower},        // Vertex 16
+      {x_outlet, y_extern, 0},              // Vertex 17
+      {x_extern, y_extern, z_lower},        // Vertex 18
+      {x_extern, y_extern, 0},              // Vertex 19
+      {x_outlet, 0, z_upper},               // Vertex 20
+      {x_outlet, y_expansion, z_upper},     // Vertex 21
+      {x_extern, 0, z_upper},               // Vertex 22
+      {x_extern, y_expansion, z_upper},     // Vertex 23
+      {x_outlet, y_extern, z_upper},        // Vertex 24
+      {x_extern, y_extern, z_upper},        // Vertex 25
       // Vértices para a espessura externa do canal na região do extern
       // Bloco 4: espessura em Y (parte inferior z)
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 26
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " 0" + ")",  // Vertex 27
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(-height_channel_half) + ")",  // Vertex 28
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " 0" + ")",  // Vertex 29
+      {x_outlet, y_thickness, z_lower},     // Vertex 26
+      {x_outlet, y_thickness, 0},           // Vertex 27
+      {x_extern, y_thickness, z_lower},     // Vertex 28
+      {x_extern, y_thickness, 0},           // Vertex 29
       // Bloco 5: espessura em Z (topo, z positivo)
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(height_channel_half) + ")",  // Vertex 30
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(height_channel_half) + ")",  // Vertex 31
+      {x_outlet, y_thickness, z_upper},     // Vertex 30
+      {x_extern, y_thickness, z_upper},     // Vertex 31
       // Bloco 7: externo em Z (topo externo)
-      "(" + std::to_string(length_inlet + length_expansion) + " 0 " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 32
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " 0 " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 33
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 34
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion * 0.5 + channel_thickness + width_extern) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 35
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 36
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 37
-      "(" + std::to_string(length_inlet + length_expansion) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 38
-      "(" + std::to_string(length_inlet + length_expansion + length_extern) + " " +
-          std::to_string(width_expansion / 2 + channel_thickness) + " " +
-          std::to_string(height_channel_half + height_extern) + ")",  // Vertex 39
+      {x_outlet, 0, z_extern},              // Vertex 32
+      {x_extern, 0, z_extern},              // Vertex 33
+      {x_outlet, y_extern, z_extern},       // Vertex 34
+      {x_extern, y_extern, z_extern},       // Vertex 35
+      {x_outlet, y_expansion, z_extern},    // Vertex 36
+      {x_extern, y_expansion, z_extern},    // Vertex 37
+      {x_outlet, y_thickness, z_extern},    // Vertex 38
+      {x_extern, y_thickness, z_extern},    // Vertex 39
   };
 
-  std::string vertices_string;
-  for (const auto& vertex : vertices) {
-    vertices_string += "    " + vertex + "\n";
-  }
-
-  auto n_cells_y_external = n_cells_y + n_cells_y_thickness + n_cells_y_extern;
-
-  // Reorganização dos blocos com nomenclatura clara
-  std::string mesh_sizes_canal_inlet = std::to_string(n_cells_x_inlet) + " " +
-                                       std::to_string(n_cells_y) + " " + std::to_string(n_cells_z);
-  std::string mesh_sizes_canal_divergente = std::to_string(n_cells_x_expansion) + " " +
-                                            std::to_string(n_cells_y) + " " +
-                                            std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_center = std::to_string(n_cells_x_extern) + " " +
-                                         std::to_string(n_cells_y) + " " +
-                                         std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_espessura_y = std::to_string(n_cells_x_extern) + " " +
-                                              std::to_string(n_cells_y_thickness) + " " +
-                                              std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_espessura_z = std::to_string(n_cells_x_extern) + " " +
-                                              std::to_string(n_cells_y_thickness) + " " +
-                                              std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_externo_y = std::to_string(n_cells_x_extern) + " " +
-                                            std::to_string(n_cells_y_extern) + " " +
-                                            std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_externo_y_full = std::to_string(n_cells_x_extern) + " " +
-                                                 std::to_string(n_cells_y_extern) + " " +
-                                                 std::to_string(2 * n_cells_z);
-  std::string mesh_sizes_outlet_externo_z_lower = std::to_string(n_cells_x_extern) + " " +
-                                                  std::to_string(n_cells_y) + " " +
-                                                  std::to_string(n_cells_z);
-  std::string mesh_sizes_outlet_externo_z_upper_center = std::to_string(n_cells_x_extern) + " " +
-                                                         std::to_string(n_cells_y) + " " +
-                                                         std::to_string(n_cells_z_extern);
-  std::string mesh_sizes_outlet_externo_z_upper_thickness = std::to_string(n_cells_x_extern) + " " +
-                                                            std::to_string(n_cells_y_thickness) +
-                                                            " " + std::to_string(n_cells_z_extern);
-  std::string mesh_sizes_outlet_externo_z_upper_extern = std::to_string(n_cells_x_extern) + " " +
-                                                         std::to_string(n_cells_y_extern) + " " +
-                                                         std::to_string(n_cells_z_extern);
-
   // Formatação BlockMesh
   const double inv_grading_ratio_y = 1.0 / grading_ratio_y;
   const double inv_grading_ratio_z = 1.0 / grading_ratio_z;
 
   // A malha vai do plano de simetria (inicio do bloco) até a parede (fim do bloco), começando
   // grande e terminando pequena. Expansion ratio = last / first = min / max = inv_grading
-  std::string simple_grading_y           = std::to_string(inv_grading_ratio_y);
-  std::string simple_grading_y_thickness = std::to_string(grading_ratio_y_thickness);
-
-  std::string simple_grading_z_lower     = std::to_string(inv_grading_ratio_z);
-  std::string simple_grading_z_upper =
-      std::to_string(grading_ratio_z);  // z=0 até z=h/2 cresce do pequeno (parede) pro grande
-
-  // Formatados para blockMeshDict
-  std::string grading_canal_inlet = "(1 " + simple_grading_y + " " + simple_grading_z_lower + ")";
-  std::string grading_canal_divergente =
-      "(1 " + simple_grading_y + " " + simple_grading_z_lower + ")";
+  const double grading_y           = inv_grading_ratio_y;
+  const double grading_y_thickness = grading_ratio_y_thickness;
 
-  std::string grading_outlet_center = grading_canal_divergente;
-  std::string grading_outlet_center_upper =
-      "(1 " + simple_grading_y + " " + simple_grading_z_upper + ")";
+  const double grading_z_lower     = inv_grading_ratio_z;
+  const double grading_z_upper =
+      grading_ratio_z;  // z=0 até z=h/2 cresce do pequeno (parede) pro grande
 
   // Nas paredes e regiões externas, usa uniforme ou propaga o grading dos vizinhos
-  std::string uniform_grading = "1";
+  const double uniform_grading = 1.0;
 
-  // Bloco 4 (espessura Y): Compartilha Y com espessura (min -> max), e Z inferior
-  std::string grading_outlet_espessura_y =
-      "(1 " + simple_grading_y_thickness + " " + simple_grading_z_lower + ")";
-
-  // Bloco 5b (espessura Z): Compartilha Y com espessura, e Z superior
-  std::string grading_outlet_espessura_z =
-      "(1 " + simple_grading_y_thickness + " " + simple_grading_z_upper + ")";
+  // Reorganização dos blocos com nomenclatura clara
+  mesh.blocks = {
+      {"Bloco 1: Canal de entrada (inlet)",
+       {0, 4, 6, 2, 1, 5, 7, 3},
+       {n_cells_x_inlet, n_cells_y, n_cells_z},
+       {1, grading_y, grading_z_lower}},
+      {"Bloco 2: Canal divergente",
+       {4, 8, 10, 6, 5, 9, 11, 7},
+       {n_cells_x_expansion, n_cells_y, n_cells_z},
+       {1, grading_y, grading_z_lower}},
+      {"Bloco 3: Centro da saída (parte inferior z)",
+       {8, 12, 14, 10, 9, 13, 15, 11},
+       {n_cells_x_extern, n_cells_y, n_cells_z},
+       {1, grading_y, grading_z_lower}},
+      // Compartilha Y com espessura (min -> max), e Z inferior
+      {"Bloco 4: Espessura do canal em Y (parte inferior z)",
+       {10, 14, 28, 26, 11, 15, 29, 27},
+       {n_cells_x_extern, n_cells_y_thickness, n_cells_z},
+       {1, grading_y_thickness, grading_z_lower}},
+      {"Bloco 5a: Topo da seção central (y=0..W/2, z=0..+height)",
+       {9, 13, 15, 11, 20, 22, 23, 21},
+       {n_cells_x_extern, n_cells_y, n_cells_z},
+       {1, grading_y, grading_z_upper}},
+      // Compartilha Y com espessura, e Z superior
+      {"Bloco 5b: Topo da espessura (y=W/2..W/2+espessura, z=0..+height)",
+       {11, 15, 29, 27, 21, 23, 31, 30},
+       {n_cells_x_extern, n_cells_y_thickness, n_cells_z},
+       {1, grading_y_thickness, grading_z_upper}},
+      // Blocos 6a/6b puros externos (sem compartilhamento em Y)
+      {"Bloco 6a (inferior): Parte externa Y (z=-h/2..0)",
+       {26, 28, 18, 16, 27, 29, 19, 17},
+       {n_cells_x_extern, n_cells_y_extern, n_cells_z},
+       {1, uniform_grading, grading_z_lower}},
+      {"Bloco 6b (superior): Parte externa Y (z=0..+h/2)",
+       {27, 29, 19, 17, 30, 31, 25, 24},
+       {n_cells_x_extern, n_cells_y_extern, n_cells_z},
+       {1, uniform_grading, grading_z_upper}},
+      // Compartilha Y com canal, Z externo
+      {"Bloco 7a: Parte externa Z (superior, y=0..width_expansion/2)",
+       {20, 22, 23, 21, 32, 33, 37, 36},
+       {n_cells_x_extern, n_cells_y, n_cells_z_extern},
+       {1, grading_y, uniform_grading}},
+      // Compartilha face com 7a, deve ter mesmo grading
+      {"Bloco 7b: Parte externa Z (superior, y=width_expansion/2..thickness)",
+       {21, 23, 31, 30, 36, 37, 39, 38},
+       {n_cells_x_extern, n_cells_y_thickness, n_cells_z_extern},
+       {1, grading_y_thickness, uniform_grading}},
+      {"Bloco 7c: Parte externa Z (superior, y=thickness..extern)",
+       {30, 31, 25, 24, 38, 39, 35, 34},
+       {n_cells_x_extern, n_cells_y_extern, n_cells_z_extern},
+       {1, 1, 1}},
+  };
 
-  // Bloco 7a (Z externo superior central): Compartilha Y com canal, Z externo
-  std::string grading_outlet_externo_z_upper_center =
-      "(1 " + simple_grading_y + " " + uniform_grading + ")";
+  mesh.patches = {
+      {"inlet", "patch", {{0, 1, 2, 3}}},
+      {"outlet",
+       "patch",
+       {
+           {12, 13, 14, 15},  // Saida do centro (Bloco 3)
+           {13, 22, 23, 15},  // Saida do topo centro (Bloco 5a)
+           {15, 23, 31, 29},  // Saida do topo espessura (Bloco 5b)
+           {14, 15, 29, 28},  // Saida da espessura em Y (Bloco 4)
+           {28, 18, 19, 29},  // Saida externa em Y (Bloco 6a/6b)
+           {29, 19, 25, 31},
+           {22, 23, 37, 33},  // Saida do externo Z superior (Bloco 7a/7b/7c)
+           {23, 31, 39, 37},
+           {31, 25, 35, 39},
+           // Extern agrupado no outlet (faces externas)
+           {16, 18, 19, 17},  // Faces externas normal a y (Bloco 6a/6b)
+           {17, 19, 25, 24},
+           {26, 16, 17, 27},  // Face externa normal a x (entrada externa, Bloco 6a/6b)
+           {27, 17, 24, 30},
+           {20, 21, 36, 32},  // Face externa normal a x (entrada externa, Bloco 7a)
+           {21, 30, 38, 36},  // Face externa normal a x (entrada externa, Bloco 7b)
+           {30, 24, 34, 38},  // Face externa normal a x (entrada externa, Bloco 7c)
+           {24, 25, 35, 34},  // Face externa normal a y (lado externo, Bloco 7c)
+           {32, 33, 37, 36},  // Face externa normal a z (topo externo, Bloco 7a/7b/7c)
+           {36, 37, 39, 38},
+           {38, 39, 35, 34},
+       }},
+      {"plane_symmetry_z",
+       "symmetryPlane",
+       {
+           {0, 2, 4, 6},
+           {4, 6, 8, 10},
+           {8, 10, 12, 14},
+           {10, 26, 28, 14},
+           {26, 28, 18, 16},  // Bloco 6a: Parte externa Y em z=-1
+       }},
+      {"plane_symmetry_y",
+       "symmetryPlane",
+       {
+           {0, 1, 4, 5},
+           {4, 5, 8, 9},
+           {8, 9, 12, 13},
+           {9, 20, 22, 13},   // Lado de simetria do bloco 5a (y=0)
+           {20, 22, 33, 32},  // Lado de simetria do bloco 7a (y=0)
+       }},
+      {"canal_wall",
+       "wall",
+       {
+           {2, 3, 6, 7},      // Parede superior (top) do inlet - Bloco 1
+           {1, 3, 5, 7},      // Back (parede inferior) do inlet - Bloco 1
+           {6, 7, 10, 11},    // Parede superior (top) do divergente - Bloco 2
+           {5, 7, 9, 11},     // Back (parede inferior) do divergente - Bloco 2
+           // Canal wall thickness agrupado no canal_wall
+           {10, 26, 27, 11},  // Face normal a x da espessura (Bloco 4)
+           {11, 27, 30, 21},  // Face normal a x da espessura (Bloco 5b)
+           {9, 11, 20, 21},   // Face normal a x do topo (Bloco 5a)
+       }},
+  };
 
-  // Blocos 6a/6b puros externos (sem compartilhamento em Y)
-  std::string grading_outlet_externo_y =
-      "(1 " + uniform_grading + " " + simple_grading_z_lower + ")";
-  std::string grading_outlet_externo_y_upper =
-      "(1 " + uniform_grading + " " + simple_grading_z_upper + ")";
+  if (refine_flame) {
+    // Tamanho de célula alvo h(x): fino na faixa [band_start, band_end] e crescendo linearmente fora
+    // dela até o tamanho grosso. Cada bloco é dividido nos pontos em que h(x) muda de regime e cada
+    // trecho vira uma seção do simpleGrading, com razão h(fim)/h(início). Como h(x) é global, blocos
+    // vizinhos com a mesma faixa em x recebem a mesma distribuição e a malha continua conforme.
+    double band_half  = std::max(10.0 * flame.thickness * 1000.0, flame_band_margin);
+    double band_start = x_flame - band_half;
+    double band_end   = x_flame + band_half;
+    double ramp       = (coarse_cell_size_x - max_cell_size_x) / growth_cell_size_x;
+
+    auto cell_size_x = [&](double x) {
+      double distance = std::max({band_start - x, x - band_end, 0.0});
+      return std::min(coarse_cell_size_x, max_cell_size_x + growth_cell_size_x * distance);
+    };
+
+    long n_cells_uniform = mesh.nCells();
+    for (auto& block : mesh.blocks) {
+      double x0 = mesh.vertices[block.vertices[0]][0];
+      double x1 = mesh.vertices[block.vertices[1]][0];
+
+      std::vector<double> breaks = {x0, x1};
+      for (double x : {band_start - ramp, band_start, band_end, band_end + ramp}) {
+        if (x > x0 && x < x1) {
+          breaks.push_back(x);
+        }
+      }
+      std::sort(breaks.begin(), breaks.end());
+
+      block.cells[0] = 0;
+      block.grading_x.clear();
+      for (size_t n = 0; n + 1 < breaks.size(); n++) {
+        double L  = breaks[n + 1] - breaks[n];
+        double hs = cell_size_x(breaks[n]);
+        double he = cell_size_x(breaks[n + 1]);
+        // Número de células de uma distribuição com h variando linearmente: integral de dx/h(x)
+        double n_exact = std::abs(he - hs) < 1e-9 ? L / hs : L * std::log(he / hs) / (he - hs);
+        int cells      = std::max(1, static_cast<int>(std::round(n_exact)));
+        block.grading_x.push_back({L, cells, cells > 1 ? he / hs : 1.0});
+        block.cells[0] += cells;
+      }
+    }
 
-  std::string grading_outlet_externo_z_upper_thickness =
-      "(1 " + simple_grading_y_thickness + " " + uniform_grading + ")";
-  std::string grading_outlet_externo_z_upper_extern = "(1 1 1)";
+    std::cout << "Refinamento da chama: faixa x = [" << band_start << ", " << band_end
+              << "] mm, " << mesh.nCells() << " células (" << n_cells_uniform
+              << " com dx uniforme)" << std::endl;
+  }
 
   // TODO: Ajustar as malhas
   // TODO: Ajuster os arquivos de condição de contorno
 
-  const char* foamRunEnv = std::getenv("FOAM_RUN");
-  if (foamRunEnv == nullptr) {
-    std::cerr << "Erro: A variável de ambiente FOAM_RUN não está definida." << std::endl;
-    return 1;  // Retorna um código de erro
-  }
-  //  Copy canal_base to canal (resolve absolute path to template)
-  std::string dirPath = std::string(foamRunEnv) + "/canal";
-
-  // Template simples: espera encontrar ./canal_base no diretório atual
-  std::filesystem::path templateDir;
-  if (const char* env_p = std::getenv("BUILD_WORKSPACE_DIRECTORY")) {
-    templateDir = std::filesystem::path(env_p) / "canal_base";
-  } else {
-    templateDir = std::filesystem::path("/home/Shinmen/Workspace Cloud/flame-speed/canal_base");
-  }
-
-  if (!std::filesystem::exists(templateDir)) {
-    std::cerr << "Erro: Diretório template 'canal_base' não encontrado em: " << templateDir
-              << std::endl;
-    return 1;
+  auto decomposition = plan_decomposition(mesh, params.cells_per_core, params.max_cores);
+  if (summary != nullptr) {
+    *summary = {mesh.nCells(), decomposition.n_subdomains, mesh_extent_cells(mesh)};
   }
 
-  // Ensure destination exists before copying
-  if (std::filesystem::exists(dirPath)) {
-    for (const auto& entry : std::filesystem::directory_iterator(dirPath)) {
-      std::filesystem::remove_all(entry.path());
+  // Espécies com arquivo 0/<espécie>: sem mecanismo, só as da entrada; com mecanismo, todas as que
+  // sobreviveram à redução (as demais ficam de fora do caso)
+  std::map<std::string, double> species_concentrations = initial_concentrations;
+  std::vector<std::string> case_species =
+      readFoamSpeciesList((templ.directory() / "constant/thermo.compressibleGas").string());
+  std::shared_ptr<Cantera::Solution> mechanism;
+  if (!mechanism_path.empty()) {
+    try {
+      mechanism = Cantera::newSolution(mechanism_path, "", "mixture-averaged");
+
+      std::set<std::string> keep;
+      for (const auto& [molecule, concentration] : initial_concentrations) {
+        keep.insert(molecule);
+      }
+      case_species = foam_active_species(mechanism, keep);
+      for (const auto& molecule : case_species) {
+        species_concentrations.emplace(molecule, 0.0);
+      }
+    } catch (std::exception& err) {
+      std::cerr << "Erro: Não foi possível carregar o mecanismo " << mechanism_path << ": "
+                << err.what() << std::endl;
+      return 1;
     }
   }
-  std::filesystem::create_directories(dirPath);
-  std::filesystem::copy(
-      templateDir,
-      dirPath,
-      std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing);
-
-  // Tenta só marcar buildrun.sh como executável; ignora erros
-  auto buildrun = std::filesystem::path(dirPath) / "buildrun.sh";
-  if (std::filesystem::exists(buildrun)) {
-    std::filesystem::permissions(buildrun,
-                                 std::filesystem::perms::owner_exec |
-                                     std::filesystem::perms::group_exec |
-                                     std::filesystem::perms::others_exec,
-                                 std::filesystem::perm_options::add);
-  }
-
-  std::string blockMeshfilePath                            = dirPath + "/system/blockMeshDict";
-  std::map<std::string, std::string> blockMeshReplacements = {
-      {"${vertex_list}", vertices_string},
-      {"${mesh_sizes_canal_inlet}", mesh_sizes_canal_inlet},
-      {"${mesh_sizes_canal_divergente}", mesh_sizes_canal_divergente},
-      {"${mesh_sizes_outlet_center}", mesh_sizes_outlet_center},
-      {"${mesh_sizes_outlet_espessura_y}", mesh_sizes_outlet_espessura_y},
-      {"${mesh_sizes_outlet_espessura_z}", mesh_sizes_outlet_espessura_z},
-      {"${mesh_sizes_outlet_externo_y}", mesh_sizes_outlet_externo_y},
-      {"${mesh_sizes_outlet_externo_y_full}", mesh_sizes_outlet_externo_y_full},
-      {"${mesh_sizes_outlet_externo_z_lower}", mesh_sizes_outlet_externo_z_lower},
-      {"${mesh_sizes_outlet_externo_z_upper_center}", mesh_sizes_outlet_externo_z_upper_center},
-      {"${mesh_sizes_outlet_externo_z_upper_thickness}",
-       mesh_sizes_outlet_externo_z_upper_thickness},
-      {"${mesh_sizes_outlet_externo_z_upper_extern}", mesh_sizes_outlet_externo_z_upper_extern},
-      {"${grading_canal_inlet}", grading_canal_inlet},
-      {"${grading_canal_divergente}", grading_canal_divergente},
-      {"${grading_outlet_center}", grading_outlet_center},
-      {"${grading_outlet_center_upper}", grading_outlet_center_upper},
-      {"${grading_outlet_espessura_y}", grading_outlet_espessura_y},
-      {"${grading_outlet_espessura_z}", grading_outlet_espessura_z},
-      {"${grading_outlet_externo_z_upper_center}", grading_outlet_externo_z_upper_center},
-      {"${grading_outlet_externo_y}", grading_outlet_externo_y},
-      {"${grading_outlet_externo_y_upper}", grading_outlet_externo_y_upper},
-      {"${grading_outlet_externo_z_upper_thickness}", grading_outlet_externo_z_upper_thickness},
-      {"${grading_outlet_externo_z_upper_extern}", grading_outlet_externo_z_upper_extern},
-  };
-  replaceInFile(blockMeshfilePath, blockMeshReplacements);
 
-  std::map<std::string, double> initial_concentrations = {
-      {"CH4", 0.055},
-      {"N2", 0.724},
-      {"O2", 0.22},
-  };
-
-  std::map<std::string, double> external_concentrations = {
-      {"CH4", 0.0},
-      {"N2", 0.767},
-      {"O2", 0.233},
+  // ===== Inicialização a partir da chama 1-D =====
+  std::map<std::string, std::string> internal_fields = {
+      {"T", "uniform " + std::to_string(temperature_inlet)},
+      {"U", "uniform (0 0 0)"},
   };
+  for (const auto& [molecule, concentration] : species_concentrations) {
+    internal_fields[molecule] = "uniform " + std::to_string(concentration);
+  }
 
-  for (const auto& [molecule, concentration] : initial_concentrations) {
-    std::string Y_temp_template_path = (templateDir / "0/Y_temp").string();
-    std::string Y_temp_output_path   = dirPath + "/0/" + molecule;
-
-    std::ifstream Y_temp_originalFile(Y_temp_template_path);
-    std::ofstream Y_temp_output_file(Y_temp_output_path);
-
-    if (!Y_temp_originalFile.is_open()) {
-      std::cerr << "Erro: Não foi possível abrir o arquivo base Y_temp." << std::endl;
-      return 1;  // Retorna um código de erro
-    }
-    if (!Y_temp_output_file.is_open()) {
-      std::cerr << "Erro: Não foi possível criar o arquivo Y_temp." << std::endl;
-      return 1;  // Retorna um código de erro
+  if (init_flame) {
+    auto centres  = mesh.cellCentres();
+    size_t ncells = centres.size();
+    std::vector<double> T_cells(ncells), U_cells(ncells), z_cells(ncells);
+    for (size_t c = 0; c < ncells; c++) {
+      auto [x, y, z] = centres[c];
+      z_cells[c]     = z_mid + (x - x_flame) * 0.001;
+      T_cells[c]     = interpolateProfile(profile.z, profile.T, z_cells[c]);
+      // Fora do canal (região externa, incluindo a saída além de x_outlet) o ar parte do repouso,
+      // como no template
+      bool in_channel = x <= x_outlet && z < 0.0 && y < half_width(x);
+      U_cells[c]      = in_channel ? velocity_inlet * y_inlet / half_width(x) *
+                                         interpolateProfile(profile.z, profile.u, z_cells[c]) /
+                                         profile.u.front()
+                                   : 0.0;
     }
-
-    std::string line;
-    while (std::getline(Y_temp_originalFile, line)) {
-      size_t pos = line.find("${MOLECULE}");
-      if (pos != std::string::npos) {
-        line.replace(pos, 11, molecule);
+    internal_fields["T"] = nonuniformField(T_cells);
+    internal_fields["U"] = nonuniformField(U_cells, true);
+
+    // Só as espécies transportadas no caso, renormalizadas para somar 1
+    std::vector<std::vector<double>> Y_cells;
+    std::vector<double> Y_sum(ncells, 0.0);
+    for (const auto& molecule : case_species) {
+      auto k = std::find(profile.species.begin(), profile.species.end(), molecule);
+      Y_cells.emplace_back(ncells, 0.0);
+      if (k == profile.species.end()) {
+        continue;
       }
-      pos = line.find("${initial_concentration}");
-      if (pos != std::string::npos) {
-        line.replace(pos, 24, std::to_string(concentration));
+      for (size_t c = 0; c < ncells; c++) {
+        Y_cells.back()[c] =
+            interpolateProfile(profile.z, profile.Y[k - profile.species.begin()], z_cells[c]);
+        Y_sum[c] += Y_cells.back()[c];
       }
-      pos = line.find("${concentration_extern}");
-      if (pos != std::string::npos) {
-        line.replace(pos, 23, std::to_string(external_concentrations[molecule]));
+    }
+    for (size_t s = 0; s < case_species.size(); s++) {
+      for (size_t c = 0; c < ncells; c++) {
+        Y_cells[s][c] /= std::max(Y_sum[c], 1e-12);
       }
-      Y_temp_output_file << line << std::endl;
+      internal_fields[case_species[s]] = nonuniformField(Y_cells[s]);
+      species_concentrations.emplace(case_species[s], 0.0);
     }
-    Y_temp_originalFile.close();
-    Y_temp_output_file.close();
   }
 
-  // Delete temporary Y_temp file
-  std::string Y_temp_filePath = dirPath + "/0/Y_temp";
-  std::filesystem::remove(Y_temp_filePath);
 
   // ===== Substituições no controlDict e U =====
   // Preparar formato de tempo e velocidade para substituição
@@ -460,23 +736,6 @@ int main(int argc, char** argv) {
   }
   velocity_inlet_str = "(" + velocity_inlet_str + " 0 0)";  // Formato para arquivo U
 
-  // Substituir no controlDict
-  std::string controlDictPath                                = dirPath + "/system/controlDict";
-  std::map<std::string, std::string> controlDictReplacements = {
-      {"${time_simulation}", time_simulation_str}};
-  replaceInFile(controlDictPath, controlDictReplacements);
-
-  // Substituir no arquivo U (velocidade inicial)
-  std::string U_filePath                            = dirPath + "/0/U";
-  std::map<std::string, std::string> U_replacements = {{"${velocity_inlet}", velocity_inlet_str}};
-  replaceInFile(U_filePath, U_replacements);
-
-  // Substituir no fvModels (tempo de inicio da ignicao)
-  std::string fvModelsPath                                = dirPath + "/constant/fvModels";
-  std::map<std::string, std::string> fvModelsReplacements = {
-      {"${time_start_ignition}", time_cold_flow_str}};
-  replaceInFile(fvModelsPath, fvModelsReplacements);
-
   std::string position_ignition_flame_str = std::to_string(position_ignition_flame_val);
   // Remove trailing zeros
   position_ignition_flame_str.erase(position_ignition_flame_str.find_last_not_of('0') + 1,
@@ -487,13 +746,237 @@ int main(int argc, char** argv) {
   // Formato vetorial (X 0 0)
   std::string position_ignition_flame_vec = "(" + position_ignition_flame_str + " 0 0)";
 
-  // Substituir no createZonesDict
-  std::string createZonesPath                                = dirPath + "/system/createZonesDict";
-  std::map<std::string, std::string> createZonesReplacements = {
-      {"${position_ignition_flame}", position_ignition_flame_vec}};
-  replaceInFile(createZonesPath, createZonesReplacements);
+  // ===== Geração do caso =====
+  // Ensure destination exists and is empty
+  if (std::filesystem::exists(dirPath)) {
+    for (const auto& entry : std::filesystem::directory_iterator(dirPath)) {
+      std::filesystem::remove_all(entry.path());
+    }
+  }
+  std::filesystem::create_directories(dirPath);
+
+  template_values case_values = {
+      {"vertex_list", mesh.blockMeshVertices()},
+      {"block_list", mesh.blockMeshBlocks()},
+      {"boundary_list", mesh.blockMeshBoundary()},
+      {"time_simulation", time_simulation_str},
+      {"velocity_inlet", velocity_inlet_str},
+      {"time_start_ignition", time_cold_flow_str},
+      {"ignition_active", init_flame ? "off" : "on"},
+      {"position_ignition_flame", position_ignition_flame_vec},
+      {"number_of_subdomains", std::to_string(decomposition.n_subdomains)},
+      {"decomposition_n", decomposition.coefficients()},
+  };
+  std::map<std::string, template_values> file_values = {
+      {"0/T", {{"internal_field", internal_fields["T"]}}},
+      {"0/U", {{"internal_field", internal_fields["U"]}}},
+  };
+  // Y_temp é só o modelo dos arquivos de espécie; os dicionários do mecanismo são escritos abaixo
+  std::set<std::string> exclude = {"0/Y_temp"};
+  if (mechanism) {
+    exclude.insert({"constant/reactions", "constant/thermo.compressibleGas"});
+  }
+
+  try {
+    templ.render(dirPath, case_values, file_values, exclude);
 
-  // TODO: implementar uma forma de executar o script do OpenFOAM
+    for (const auto& [molecule, concentration] : species_concentrations) {
+      templ.renderFile("0/Y_temp",
+                        std::filesystem::path(dirPath) / "0" / molecule,
+                        {{"MOLECULE", molecule},
+                         {"internal_field", internal_fields[molecule]},
+                         {"initial_concentration", std::to_string(concentration)},
+                         {"concentration_extern", std::to_string(external_concentrations[molecule])}});
+    }
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+
+  if (params.write_polymesh) {
+    // Mesma seleção do createZonesDict: esfera em torno da posição de ignição
+    const double ignition_radius = 7.0;  // mm (radius 0.007 do createZonesDict)
+    foam_cell_zone ignition_zone{"ignitionZone", {}};
+    auto centres = mesh.cellCentres();
+    for (size_t c = 0; c < centres.size(); c++) {
+      double dx = centres[c][0] - position_ignition_flame_val * 1000.0;
+      double dy = centres[c][1];
+      double dz = centres[c][2];
+      if (dx * dx + dy * dy + dz * dz <= ignition_radius * ignition_radius) {
+        ignition_zone.cells.push_back(static_cast<int32_t>(c));
+      }
+    }
+    try {
+      write_foam_polymesh(mesh, std::filesystem::path(dirPath) / "constant/polyMesh", {ignition_zone});
+    } catch (std::exception& err) {
+      std::cerr << "Erro: " << err.what() << std::endl;
+      return 1;
+    }
+  }
+
+  if (mechanism) {
+    try {
+      write_foam_reactions(mechanism, case_species, dirPath + "/constant/reactions");
+      write_foam_thermo(mechanism, case_species, dirPath + "/constant/thermo.compressibleGas");
+      std::cout << "Mecanismo exportado: " << mechanism->kinetics()->nReactions() << " reações, "
+                << case_species.size() << " espécies" << std::endl;
+    } catch (std::exception& err) {
+      std::cerr << "Erro: Não foi possível exportar o mecanismo " << mechanism_path << ": "
+                << err.what() << std::endl;
+      return 1;
+    }
+  }
 
   return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv) {
+  case_parameters params;
+  std::string campaign_path;
+  bool mesh_family = false;
+  unsigned threads = 0;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--mechanism" && i + 1 < argc) {
+      params.mechanism_path = argv[++i];
+    } else if (arg == "--initFlame") {
+      params.init_flame = true;
+    } else if (arg == "--refineFlame") {
+      params.refine_flame = true;
+    } else if (arg == "--writePolyMesh") {
+      params.write_polymesh = true;
+    } else if (arg == "--meshFamily") {
+      mesh_family = true;
+    } else if (arg == "--campaign" && i + 1 < argc) {
+      campaign_path = argv[++i];
+    } else if (arg == "--cellsPerCore" && i + 1 < argc) {
+      params.cells_per_core = std::stod(argv[++i]);
+    } else if (arg == "--maxCores" && i + 1 < argc) {
+      params.max_cores = static_cast<unsigned>(std::stoi(argv[++i]));
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = static_cast<unsigned>(std::stoi(argv[++i]));
+    } else {
+      std::cerr << "Uso: generate_cfd [--mechanism mecanismo.yaml] [--initFlame] [--refineFlame]\n"
+                   "                    [--writePolyMesh] [--cellsPerCore N] [--maxCores N]\n"
+                   "                    [--campaign campanha.txt | --meshFamily] [--threads N]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  const char* foamRunEnv = std::getenv("FOAM_RUN");
+  if (foamRunEnv == nullptr) {
+    std::cerr << "Erro: A variável de ambiente FOAM_RUN não está definida." << std::endl;
+    return 1;  // Retorna um código de erro
+  }
+
+  // Template simples: espera encontrar ./canal_base no diretório atual
+  std::filesystem::path templateDir;
+  if (const char* env_p = std::getenv("BUILD_WORKSPACE_DIRECTORY")) {
+    templateDir = std::filesystem::path(env_p) / "canal_base";
+  } else {
+    templateDir = std::filesystem::path("/home/Shinmen/Workspace Cloud/flame-speed/canal_base");
+  }
+
+  // O template é analisado uma vez e compartilhado (só leitura) por todos os casos
+  std::optional<case_template> templ;
+  try {
+    templ.emplace(templateDir);
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+
+  if (campaign_path.empty() && !mesh_family) {
+    return generate_case(params, *templ, std::string(foamRunEnv) + "/canal");
+  }
+
+  // ===== Campanha: um caso por combinação, em $FOAM_RUN/<campanha>/case_NNNN =====
+  std::vector<std::pair<std::string, std::vector<double>>> axes;
+  std::string campaign_name;
+  if (mesh_family) {
+    // Família de malhas para o GCI (grid_convergence): mesmos parâmetros, tamanhos de célula
+    // multiplicados por 1, sqrt(2) e 2
+    axes                        = {{"mesh_scale", {1.0, std::sqrt(2.0), 2.0}}};
+    campaign_name               = "mesh_family";
+    params.mesh_family_coarsest = 2.0;
+  } else {
+    try {
+      axes = readCampaign(campaign_path);
+    } catch (std::exception& err) {
+      std::cerr << "Erro: " << err.what() << std::endl;
+      return 1;
+    }
+    campaign_name = std::filesystem::path(campaign_path).stem().string();
+  }
+
+  size_t n_cases = 1;
+  for (const auto& [name, values] : axes) {
+    n_cases *= values.size();
+  }
+  auto campaignDir = std::filesystem::path(foamRunEnv) / campaign_name;
+  std::filesystem::create_directories(campaignDir);
+
+  std::vector<case_parameters> cases(n_cases, params);
+  std::vector<std::string> case_names(n_cases);
+  for (size_t c = 0; c < n_cases; c++) {
+    // Último parâmetro do arquivo varia mais rápido
+    size_t index = c;
+    for (size_t a = axes.size(); a-- > 0;) {
+      const auto& [name, values] = axes[a];
+      cases[c].*case_parameter_fields.at(name) = values[index % values.size()];
+      index /= values.size();
+    }
+    std::string number = std::to_string(c);
+    case_names[c] = "case_" + std::string(number.size() < 4 ? 4 - number.size() : 0, '0') + number;
+  }
+
+  std::vector<case_summary> summaries(n_cases);
+  std::vector<int> status(n_cases, 1);
+  parallel_for(n_cases, threads, [&](size_t c) {
+    // Uma exceção escapando da thread chamaria std::terminate e derrubaria a campanha inteira
+    try {
+      status[c] = generate_case(cases[c], *templ, (campaignDir / case_names[c]).string(), &summaries[c]);
+    } catch (std::exception& err) {
+      std::cerr << case_names[c] << ": " << err.what() << std::endl;
+      status[c] = 1;
+    }
+  });
+
+  if (mesh_family && status[0] == 0) {
+    // O GCI tira r de mesh_scale: cada direção precisa refinar pela mesma razão (a tolerância cobre
+    // o arredondamento das contagens pequenas). Caso 0 é a malha mais fina (mesh_scale = 1).
+    for (size_t c = 1; c < n_cases; c++) {
+      double r = cases[c].mesh_scale / cases[0].mesh_scale;
+      for (size_t d = 0; d < 3 && status[c] == 0; d++) {
+        double ratio = static_cast<double>(summaries[0].cells_xyz[d]) / summaries[c].cells_xyz[d];
+        if (std::abs(ratio / r - 1.0) > 0.1) {
+          std::cerr << case_names[c] << ": razão de células em " << "xyz"[d] << " = " << ratio
+                    << ", esperada r = " << r << std::endl;
+          status[c] = 1;
+        }
+      }
+    }
+  }
+
+  std::ofstream manifest(campaignDir / "manifest.csv", std::ios::trunc);
+  manifest << "case";
+  for (const auto& [name, values] : axes) {
+    manifest << "," << name;
+  }
+  manifest << ",n_cells,n_subdomains,status\n";
+  int n_failed = 0;
+  for (size_t c = 0; c < n_cases; c++) {
+    manifest << case_names[c];
+    for (const auto& [name, values] : axes) {
+      manifest << "," << cases[c].*case_parameter_fields.at(name);
+    }
+    manifest << "," << summaries[c].n_cells << "," << summaries[c].n_subdomains << ","
+             << (status[c] == 0 ? "ok" : "failed") << "\n";
+    n_failed += status[c] != 0;
+  }
+
+  std::cout << "Campanha: " << n_cases - n_failed << "/" << n_cases << " casos gerados em "
+            << campaignDir << std::endl;
+  return n_failed == 0 ? 0 : 1;
+}
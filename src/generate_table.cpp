@@ -0,0 +1,174 @@
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/stringUtils.h"
+#include "cantera/kinetics/Reaction.h"
+#include "cantera/oneD/DomainFactory.h"
+#include "cantera/onedim.h"
+#include "cantera/thermo/Species.h"
+#include "cantera/transport/TransportData.h"
+#include "flame_table.h"
+#include "lib.h"
+#include "parallel.h"
+
+// Gera a tabela S_L/Tad/Tmax/espessura sobre phi x T_u x p para consulta pelo CFD (campo G).
+//
+// Uso: generate_table [--mechanism gri30.yaml] [--phi 0.6:1.4:9] [--T 300:600:4] [--p 1:5:3]
+//                     [--threads N] [--output dir]
+// (pressões em bar)
+
+int main(int argc, char** argv) {
+  int loglevel          = 0;
+  bool refine_grid      = true;
+  double uin            = 0.3;  // m/s (apenas estimativa inicial)
+
+  auto fuel             = "CH4";
+  auto oxidizer         = "O2:1, N2:3.76";
+  std::string mechanism = "gri30.yaml";
+  unsigned threads      = 0;
+
+  std::vector<double> phi_axis = parse_axis("0.6:1.4:9");
+  std::vector<double> T_axis   = parse_axis("300:600:4");
+  std::vector<double> p_axis   = parse_axis("1:5:3");
+
+  std::string output_dir = "output";
+  if (const char* env_p = std::getenv("BUILD_WORKSPACE_DIRECTORY")) {
+    output_dir = std::string(env_p) + "/output";
+  }
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg   = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--mechanism") {
+      mechanism = value;
+    } else if (arg == "--phi") {
+      phi_axis = parse_axis(value);
+    } else if (arg == "--T") {
+      T_axis = parse_axis(value);
+    } else if (arg == "--p") {
+      p_axis = parse_axis(value);
+    } else if (arg == "--threads") {
+      threads = static_cast<unsigned>(std::stoi(value));
+    } else if (arg == "--output") {
+      output_dir = value;
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    }
+  }
+  for (auto& p : p_axis) {
+    p *= Cantera::OneBar;
+  }
+
+  std::filesystem::create_directories(output_dir);
+
+  // Frações de mistura correspondentes a cada phi
+  std::vector<double> mixture_fraction(phi_axis.size());
+  {
+    auto gas = Cantera::newSolution(mechanism, "", "mixture-averaged")->thermo();
+    for (size_t i = 0; i < phi_axis.size(); i++) {
+      gas->setEquivalenceRatio(phi_axis[i], fuel, oxidizer);
+      mixture_fraction[i] = gas->mixtureFraction(fuel, oxidizer);
+    }
+  }
+
+  // A varredura começa no ponto mais próximo da estequiometria, onde a chama converge com mais
+  // facilidade, e segue para os dois lados reaproveitando a solução vizinha
+  size_t i_center = 0;
+  for (size_t i = 0; i < phi_axis.size(); i++) {
+    if (std::abs(phi_axis[i] - 1.0) < std::abs(phi_axis[i_center] - 1.0)) {
+      i_center = i;
+    }
+  }
+
+  flame_table table(phi_axis, T_axis, p_axis);
+  std::vector<flame_profile> center_profiles(T_axis.size() * p_axis.size());
+
+  // Chama que não convergiu (exceção ou S_L <= 0) fica marcada como inválida na tabela, para não
+  // entrar na interpolação como S_L = 0
+  auto solve = [&](std::shared_ptr<Cantera::Solution> sol,
+                   size_t i_phi, size_t i_T, size_t i_p, flame_profile& profile) {
+    thermo_state state;
+    // Uma por chamada: flamespeed() limpa e preenche o mapa, que não pode ser compartilhado entre
+    // as threads do parallel_for
+    std::multimap<std::string, std::pair<std::string, double>> reactions;
+    try {
+      state = flamespeed(sol,
+                         T_axis[i_T],
+                         p_axis[i_p],
+                         uin,
+                         mixture_fraction[i_phi],
+                         fuel,
+                         oxidizer,
+                         refine_grid,
+                         loglevel,
+                         reactions,
+                         &profile);
+    } catch (Cantera::CanteraError& err) {
+      std::cout << err.what() << std::endl;
+    }
+    flame_table_entry entry{state.flamespeed, state.Tad, state.Tmax, state.thickness};
+    table.set(i_phi, i_T, i_p, entry.valid() ? entry : flame_table_entry::invalid());
+  };
+
+  // Etapa 1: eixo p no ponto central (T mínimo), sequencial
+  {
+    auto sol = Cantera::newSolution(mechanism, "", "mixture-averaged");
+    flame_profile profile;
+    for (size_t i_p = 0; i_p < p_axis.size(); i_p++) {
+      solve(sol, i_center, 0, i_p, profile);
+      center_profiles[i_p] = profile;
+    }
+  }
+
+  // Etapa 2: eixo T no ponto central, uma linha por pressão
+  parallel_for(p_axis.size(), threads, [&](size_t i_p) {
+    auto sol     = Cantera::newSolution(mechanism, "", "mixture-averaged");
+    auto profile = center_profiles[i_p];
+    for (size_t i_T = 1; i_T < T_axis.size(); i_T++) {
+      solve(sol, i_center, i_T, i_p, profile);
+      center_profiles[i_T * p_axis.size() + i_p] = profile;
+    }
+  });
+
+  // Etapa 3: eixo phi, uma linha por (T, p), partindo do ponto central
+  parallel_for(T_axis.size() * p_axis.size(), threads, [&](size_t line) {
+    size_t i_T = line / p_axis.size();
+    size_t i_p = line % p_axis.size();
+    auto sol   = Cantera::newSolution(mechanism, "", "mixture-averaged");
+
+    auto profile = center_profiles[line];
+    for (size_t i_phi = i_center + 1; i_phi < phi_axis.size(); i_phi++) {
+      solve(sol, i_phi, i_T, i_p, profile);
+    }
+    profile = center_profiles[line];
+    for (size_t i_phi = i_center; i_phi-- > 0;) {
+      solve(sol, i_phi, i_T, i_p, profile);
+    }
+  });
+
+  table.write(output_dir + "/flame_table.bin");
+  table.writeFoamDictionary(output_dir + "/laminarFlameSpeedTable");
+
+  std::cout << "Table written to " << output_dir << "/flame_table.bin and "
+            << output_dir << "/laminarFlameSpeedTable" << std::endl;
+
+  auto failed = table.invalid_points();
+  for (const auto& [i_phi, i_T, i_p] : failed) {
+    std::cerr << "Aviso: chama não convergiu em phi = " << phi_axis[i_phi] << ", T = " << T_axis[i_T]
+              << " K, p = " << p_axis[i_p] / Cantera::OneBar << " bar (ponto inválido na tabela)"
+              << std::endl;
+  }
+  if (!failed.empty()) {
+    std::cerr << failed.size() << " de " << table.data.size() / flame_table::n_fields
+              << " pontos sem chama convergida" << std::endl;
+    return 2;
+  }
+  return 0;
+}
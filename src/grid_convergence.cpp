@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "grid_convergence.h"
+
+// Estudo de convergência de malha de uma família gerada por `generate_cfd --meshFamily`.
+//
+// Uso: grid_convergence [--family $FOAM_RUN/mesh_family] [--target 0.02]
+//
+// Lê manifest.csv da família (mesh_scale e número de células de cada caso) e, de cada caso, o
+// flame.csv escrito pelo pós-processamento (última linha, colunas x_flame e flamespeed). Calcula
+// ordem aparente, valor extrapolado e GCI de cada grandeza, e recomenda a malha mais grossa cujo erro
+// estimado em relação ao valor extrapolado fica abaixo de target em todas as grandezas.
+
+std::vector<std::string> split_csv(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream stream(line);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+// Colunas de um CSV com cabeçalho: nome -> valores (todas as linhas)
+std::map<std::string, std::vector<std::string>> read_csv(const std::filesystem::path& path) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    throw std::runtime_error("não foi possível abrir " + path.string());
+  }
+  std::string line;
+  std::getline(in, line);
+  auto header = split_csv(line);
+
+  std::map<std::string, std::vector<std::string>> columns;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    auto fields = split_csv(line);
+    for (size_t c = 0; c < header.size() && c < fields.size(); c++) {
+      columns[header[c]].push_back(fields[c]);
+    }
+  }
+  return columns;
+}
+
+int main(int argc, char** argv) {
+  std::filesystem::path family_dir;
+  if (const char* foam_run = std::getenv("FOAM_RUN")) {
+    family_dir = std::filesystem::path(foam_run) / "mesh_family";
+  }
+  double target = 0.02;  // Erro relativo de discretização aceitável
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--family") {
+      family_dir = argv[i + 1];
+    } else if (arg == "--target") {
+      target = std::stod(argv[i + 1]);
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  const std::vector<std::string> quantities = {"x_flame", "flamespeed"};
+
+  struct mesh_case {
+    std::string name;
+    long n_cells;
+    double h;
+    std::map<std::string, double> values;
+  };
+  std::vector<mesh_case> meshes;
+
+  try {
+    auto manifest = read_csv(family_dir / "manifest.csv");
+    for (size_t c = 0; c < manifest["case"].size(); c++) {
+      if (manifest["status"][c] != "ok") {
+        continue;
+      }
+      auto flame = read_csv(family_dir / manifest["case"][c] / "flame.csv");
+      mesh_case mesh{manifest["case"][c], std::stol(manifest["n_cells"][c]), 0.0, {}};
+      // A razão de refinamento é a de mesh_scale (o generate_cfd confere que cada direção a segue);
+      // sem a coluna, vem do número de células
+      mesh.h = manifest["mesh_scale"].size() > c ? std::stod(manifest["mesh_scale"][c])
+                                                 : representative_cell_size(mesh.n_cells);
+      for (const auto& quantity : quantities) {
+        if (flame[quantity].empty()) {
+          throw std::runtime_error(mesh.name + "/flame.csv sem a coluna " + quantity);
+        }
+        mesh.values[quantity] = std::stod(flame[quantity].back());
+      }
+      meshes.push_back(mesh);
+    }
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+
+  if (meshes.size() < 3) {
+    std::cerr << "Erro: são necessárias três malhas com resultados (encontradas " << meshes.size()
+              << ")" << std::endl;
+    return 1;
+  }
+  std::sort(meshes.begin(), meshes.end(), [](const auto& a, const auto& b) { return a.h < b.h; });
+
+  // GCI com as três malhas mais finas; o valor extrapolado serve de referência para todas
+  std::map<std::string, gci_result> gci;
+  for (const auto& quantity : quantities) {
+    std::vector<grid_solution> solutions;
+    for (size_t m = 0; m < 3; m++) {
+      solutions.push_back({meshes[m].h, meshes[m].values[quantity]});
+    }
+    gci[quantity] = grid_convergence_index(solutions);
+
+    const auto& g = gci[quantity];
+    std::cout << quantity << ": p = " << g.order << ", extrapolado = " << g.extrapolated
+              << ", e_a21 = " << g.error_fine << ", GCI21 = " << g.gci_fine
+              << ", GCI32 = " << g.gci_medium << (g.oscillatory ? " (oscilatória)" : "")
+              << std::endl;
+  }
+
+  std::ofstream out(family_dir / "gci.csv", std::ios::trunc);
+  out << "case,n_cells,h";
+  for (const auto& quantity : quantities) {
+    out << "," << quantity << "," << quantity << "_error";
+  }
+  out << "\n";
+
+  // Da mais fina para a mais grossa, até a primeira que não atinge o alvo
+  const mesh_case* recommended = nullptr;
+  bool within_target           = true;
+  for (const auto& mesh : meshes) {
+    double worst = 0.0;
+    out << mesh.name << "," << mesh.n_cells << "," << mesh.h;
+    for (const auto& quantity : quantities) {
+      double reference = gci[quantity].extrapolated;
+      double error     = std::abs((mesh.values.at(quantity) - reference) / reference);
+      worst            = std::max(worst, error);
+      out << "," << mesh.values.at(quantity) << "," << error;
+    }
+    out << "\n";
+    within_target = within_target && worst <= target;
+    if (within_target) {
+      recommended = &mesh;
+    }
+  }
+
+  if (recommended == nullptr) {
+    std::cout << "Nenhuma malha atinge o erro alvo de " << target
+              << "; refine a família (mesh_scale menor)." << std::endl;
+    return 2;
+  }
+  std::cout << "Malha recomendada: " << recommended->name << " (" << recommended->n_cells
+            << " células) para erro <= " << target << std::endl;
+  return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+// Índice de convergência de malha (GCI) e extrapolação de Richardson pelo procedimento de
+// Celik et al. (2008), "Procedure for Estimation and Reporting of Uncertainty Due to
+// Discretization in CFD Applications", J. Fluids Eng. 130(7).
+//
+// h é o tamanho representativo de célula, h = (V/N)^(1/3); como só as razões entre malhas entram
+// nas fórmulas, basta N^(-1/3).
+
+struct grid_solution {
+  double h;    // Tamanho representativo de célula
+  double phi;  // Grandeza analisada (ex.: posição da chama, S_L)
+};
+
+struct gci_result {
+  double order;         // Ordem aparente p
+  double extrapolated;  // phi extrapolado (h -> 0) a partir das duas malhas mais finas
+  double error_fine;    // Erro relativo aproximado entre as duas malhas mais finas, e_a^21
+  double gci_fine;      // GCI da malha mais fina, GCI^21
+  double gci_medium;    // GCI da malha intermediária, GCI^32
+  bool oscillatory;     // Convergência oscilatória (epsilon32/epsilon21 < 0)
+};
+
+double representative_cell_size(long n_cells) {
+  return std::pow(static_cast<double>(n_cells), -1.0 / 3.0);
+}
+
+// solutions: três malhas em qualquer ordem; usa 1 = mais fina, 3 = mais grossa
+gci_result grid_convergence_index(std::vector<grid_solution> solutions, double safety_factor = 1.25) {
+  if (solutions.size() != 3) {
+    throw std::runtime_error("grid_convergence_index: são necessárias exatamente três malhas");
+  }
+  std::sort(solutions.begin(), solutions.end(), [](const auto& a, const auto& b) {
+    return a.h < b.h;
+  });
+  const auto& [h1, phi1] = solutions[0];
+  const auto& [h2, phi2] = solutions[1];
+  const auto& [h3, phi3] = solutions[2];
+
+  double r21   = h2 / h1;
+  double r32   = h3 / h2;
+  double eps21 = phi2 - phi1;
+  double eps32 = phi3 - phi2;
+
+  gci_result result{};
+  if (std::abs(eps21) < 1e-14 * std::max(1.0, std::abs(phi1))) {
+    // Malhas finas já coincidem: nada a extrapolar
+    result = {0.0, phi1, 0.0, 0.0, std::abs(eps32 / phi2), false};
+    return result;
+  }
+  double ratio       = eps32 / eps21;
+  double s           = ratio >= 0 ? 1.0 : -1.0;
+  result.oscillatory = ratio < 0;
+
+  // p = |ln|eps32/eps21| + q(p)| / ln(r21), q(p) = ln((r21^p - s)/(r32^p - s)), por ponto fixo
+  double p = std::abs(std::log(std::abs(ratio))) / std::log(r21);
+  for (int it = 0; it < 100; it++) {
+    double q     = std::log((std::pow(r21, p) - s) / (std::pow(r32, p) - s));
+    double p_new = std::abs(std::log(std::abs(ratio)) + q) / std::log(r21);
+    if (!std::isfinite(p_new)) {
+      break;
+    }
+    bool converged = std::abs(p_new - p) < 1e-10;
+    p              = p_new;
+    if (converged) {
+      break;
+    }
+  }
+  result.order = p;
+
+  double r21p         = std::pow(r21, p);
+  double r32p         = std::pow(r32, p);
+  result.extrapolated = (r21p * phi1 - phi2) / (r21p - 1.0);
+  result.error_fine   = std::abs((phi1 - phi2) / phi1);
+  result.gci_fine     = safety_factor * result.error_fine / (r21p - 1.0);
+  result.gci_medium   = safety_factor * std::abs((phi2 - phi3) / phi2) / (r32p - 1.0);
+  return result;
+}
@@ -1,6 +1,15 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <unordered_map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -10,6 +19,7 @@
 #include "cantera/base/Solution.h"
 #include "cantera/base/logger.h"
 #include "cantera/base/stringUtils.h"
+#include "telemetry.h"
 
 struct thermo_state {
   // TODO: Melhorar o nome
@@ -17,16 +27,90 @@ struct thermo_state {
   double Tad;
   double Tmax;
   double zmax;
+  double thickness;  // Espessura térmica: (T_b - T_u) / max(dT/dz)
 
   operator double() const { return flamespeed; }
 
-  thermo_state() : flamespeed(0.0), Tad(0.0), Tmax(0.0), zmax(0.0) {}
-  thermo_state(double fs, double tad, double tmax, double zmax)
-      : flamespeed(fs), Tad(tad), Tmax(tmax), zmax(zmax) {}
+  thermo_state() : flamespeed(0.0), Tad(0.0), Tmax(0.0), zmax(0.0), thickness(0.0) {}
+  thermo_state(double fs, double tad, double tmax, double zmax, double thickness = 0.0)
+      : flamespeed(fs), Tad(tad), Tmax(tmax), zmax(zmax), thickness(thickness) {}
 
   ~thermo_state() = default;
 };
 
+// Perfil 1-D de uma chama já resolvida. Quando passado para flamespeed() com dados, é usado como
+// estimativa inicial (warm start); depois de uma solução bem sucedida é sobrescrito com o novo
+// perfil.
+struct flame_profile {
+  std::vector<double> z;
+  std::vector<double> T;
+  std::vector<double> u;
+  std::vector<std::string> species;
+  std::vector<std::vector<double>> Y;  // Y[k][n]: fração mássica da espécie k no ponto n
+
+  bool empty() const { return z.size() < 2; }
+};
+
+// Uma linha da varredura em fração de mistura (mecanismo reduzido e completo)
+struct output {
+  double ratio_fuel_ox;
+  double speed_flame_reduced;
+  double temperature_ad_reduced;
+  double temperature_max_reduced;
+  double z_t_max_reduced;
+  double speed_flame_full;
+  double temperature_ad_full;
+  double temperature_max_full;
+  double z_t_max_full;
+};
+
+// flame_speed_data.csv, ordenado por fração de mistura (main e o merge do campaign)
+void write_flame_speed_data(const std::string& path,
+                            std::vector<output> results,
+                            double mixture_fraction_stoichiometric,
+                            size_t num_reactions_reduced) {
+  //  sort results by mixture fraction
+  std::sort(results.begin(), results.end(), [](const output& a, const output& b) {
+    return a.ratio_fuel_ox < b.ratio_fuel_ox;
+  });
+
+  std::ofstream out_data(path);
+  out_data << "Mixture fraction, Equivalence ratio (reduced mechanism " << num_reactions_reduced
+           << "), "
+              "Flame Speed (reduced mechanism "
+           << num_reactions_reduced
+           << ") [m/s], "
+              "Adiabatic flame temperature (reduced mechanism "
+           << num_reactions_reduced
+           << ") [K], "
+              "Maximum temperature (reduced mechanism "
+           << num_reactions_reduced
+           << ") [K], "
+              "Z_max (reduced mechanism "
+           << num_reactions_reduced
+           << ") [m], "
+              "Ignition delay time (reduced mechanism "
+           << num_reactions_reduced
+           << ") [s], "
+              "Flame Speed (complete mechanism) [m/s], "
+              "Adiabatic flame temperature (complete mechanism) [K], "
+              "Maximum temperature (complete mechanism) [K], "
+              "Z_max (complete mechanism) [m], "
+              "Ignition delay time (complete mechanism) [s]\n";
+  for (auto r : results) {
+    auto new_phi                     = r.ratio_fuel_ox / (mixture_fraction_stoichiometric);
+
+    auto ignition_delay_time_reduced = r.z_t_max_reduced / (r.speed_flame_reduced);
+    auto ignition_delay_time_full    = r.z_t_max_full / (r.speed_flame_full);
+
+    out_data << r.ratio_fuel_ox << "," << new_phi << "," << r.speed_flame_reduced << ","
+             << r.temperature_ad_reduced << "," << r.temperature_max_reduced << ","
+             << r.z_t_max_reduced << "," << ignition_delay_time_reduced << "," << r.speed_flame_full
+             << "," << r.temperature_ad_full << "," << r.temperature_max_full << ","
+             << r.z_t_max_full << "," << ignition_delay_time_full << "\n";
+  }
+}
+
 Cantera::AnyMap mechanism_map(const Cantera::AnyMap& phases,
                               const std::vector<Cantera::AnyMap>& species,
                               const std::vector<Cantera::AnyMap>& reactions) {
@@ -46,6 +130,99 @@ Cantera::AnyMap mechanism_map(const Cantera::AnyMap& phases,
   return rootNode;
 }
 
+// Identifica uma reação do mecanismo de origem ao longo da redução: o YAML da reação sem a flag
+// "duplicate", que é apagada quando o par duplicado perde uma das reações
+std::string reaction_key(const std::string& reaction_yaml) {
+  Cantera::AnyMap rxn_data = Cantera::AnyMap::fromYamlString(reaction_yaml);
+  rxn_data.erase("duplicate");
+  return rxn_data.toYamlString();
+}
+
+// Um passo da trajetória de redução (linha de output/reaction_reduction.csv). removed guarda só as
+// reações (índices no mecanismo de origem, output/reduction_source.yaml) retiradas neste passo.
+// A última linha da redução é o candidato rejeitado (coluna rejected = 1) e não entra na trajetória,
+// nem linhas com alguma quantidade fora da tolerância (coluna violated). objective_error é o erro
+// do objetivo de várias quantidades, normalizado pela tolerância (>= 1 viola). Em passos previstos
+// (solved = false) value_diff, ratio e objective_error são a previsão, não uma chama resolvida.
+struct reduction_step {
+  size_t num_reactions;
+  double value_diff;
+  double ratio;
+  double objective_error;
+  bool solved;
+  std::vector<size_t> removed;
+};
+
+std::vector<reduction_step> read_reduction_trajectory(const std::string& path) {
+  std::ifstream in(path);
+  if (!in.is_open()) {
+    throw std::runtime_error("não foi possível abrir " + path);
+  }
+  std::vector<reduction_step> steps;
+  std::string line;
+  std::getline(in, line);  // Cabeçalho
+  while (std::getline(in, line)) {
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    for (std::string field; std::getline(stream, field, ',');) {
+      fields.push_back(field);
+    }
+    if (fields.size() < 9) {
+      throw std::runtime_error(path + ": linha sem a coluna rejected (redução anterior a ela?)");
+    }
+    if (fields[8] == "1" || !fields[7].empty()) {
+      continue;
+    }
+    reduction_step step{std::stoul(fields[0]), std::stod(fields[1]), std::stod(fields[3]),
+                        std::stod(fields[6]), fields[5] == "1", {}};
+    std::stringstream removed(fields[4]);
+    for (size_t index; removed >> index;) {
+      step.removed.push_back(index);
+    }
+    steps.push_back(step);
+  }
+  return steps;
+}
+
+// Mecanismo do passo `step` da trajetória: as reações de origem menos as removidas até ele
+Cantera::AnyMap mechanism_tier(const Cantera::AnyMap& source,
+                               const std::vector<reduction_step>& steps,
+                               size_t step) {
+  std::set<size_t> removed;
+  for (size_t s = 0; s <= step && s < steps.size(); s++) {
+    removed.insert(steps[s].removed.begin(), steps[s].removed.end());
+  }
+
+  auto source_reactions = source.at("reactions").asVector<Cantera::AnyMap>();
+  std::vector<Cantera::AnyMap> reactions;
+  std::map<std::string, int> equations;
+  for (size_t i = 0; i < source_reactions.size(); i++) {
+    if (!removed.count(i)) {
+      reactions.push_back(source_reactions[i]);
+      equations[source_reactions[i]["equation"].asString()]++;
+    }
+  }
+  // Reação duplicada cujo par foi removido deixa de ser "duplicate" (como na redução)
+  for (auto& rxn : reactions) {
+    if (rxn.hasKey("duplicate") && equations[rxn["equation"].asString()] < 2) {
+      rxn.erase("duplicate");
+    }
+  }
+
+  return mechanism_map(source.at("phases").asVector<Cantera::AnyMap>().front(),
+                       source.at("species").asVector<Cantera::AnyMap>(),
+                       reactions);
+}
+
+// Custo de uma solução de flamespeed(), somado sobre as malhas do refinamento (estatísticas do
+// OneDim do Cantera)
+struct flame_solve_stats {
+  size_t grid_points       = 0;  // Malha final
+  int jacobian_evaluations = 0;
+  int function_evaluations = 0;  // Avaliações do resíduo (iterações de Newton + passos no tempo)
+  int time_steps           = 0;
+};
+
 static std::multimap<std::string, std::pair<std::string, double>> empty_reactions;
 
 thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
@@ -58,7 +235,9 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
                         bool refine_grid,
                         int loglevel,
                         std::multimap<std::string, std::pair<std::string, double>>&
-                            reactions_weighted = empty_reactions) {
+                            reactions_weighted = empty_reactions,
+                        flame_profile* profile = nullptr,
+                        flame_solve_stats* stats = nullptr) {
   // TODO: criar situação para calcular a velocidade sem precisar retornar/modificar o
   // reactions_weighted, talzes usar std::optional e usar if para ver se tem valor ou não
   // TODO: modificar para função ao inves de ser flamespeed, calcular todos os outputs desejados,
@@ -67,6 +246,10 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
   reactions_weighted.clear();
 
   thermo_state state;
+  auto solve_start   = std::chrono::steady_clock::now();
+  auto solve_seconds = [&]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start).count();
+  };
 
   try {
     auto gas      = sol->thermo();
@@ -104,6 +287,8 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
     auto flow = Cantera::newDomain<Cantera::Flow1D>("gas-flow", sol, "flow");
     flow->setFreeFlow();
 
+    bool warm_start = (profile != nullptr) && !profile->empty();
+
     // create an initial grid
     int nz    = 6;
     double lz = 0.1;
@@ -112,15 +297,19 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
     for (int iz = 0; iz < nz; iz++) {
       z[iz] = ((double)iz) * dz;
     }
+    if (warm_start) {
+      // Reaproveita a malha da solução anterior
+      z = profile->z;
+    }
 
-    flow->setupGrid(nz, &z[0]);
+    flow->setupGrid(z.size(), &z[0]);
 
     //------- step 2: create the inlet  -----------------------
 
     auto inlet = Cantera::newDomain<Cantera::Inlet1D>("inlet", sol);
 
     inlet->setMoleFractions(x.data());
-    double mdot = uin * rho_in;
+    double mdot = (warm_start ? profile->u.front() : uin) * rho_in;
     inlet->setMdot(mdot);
     inlet->setTemperature(temperature);
 
@@ -148,6 +337,22 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
       flame.setInitialGuess(gas->speciesName(i), locs, value);
     }
 
+    if (warm_start) {
+      // Posições relativas da solução anterior; os perfis de T, u e Y são reaproveitados e só as
+      // espécies que existem nos dois mecanismos são copiadas
+      locs.resize(profile->z.size());
+      for (size_t n = 0; n < profile->z.size(); n++) {
+        locs[n] = (profile->z[n] - profile->z.front()) / (profile->z.back() - profile->z.front());
+      }
+      flame.setInitialGuess("velocity", locs, profile->u);
+      flame.setInitialGuess("T", locs, profile->T);
+      for (size_t k = 0; k < profile->species.size(); k++) {
+        if (gas->speciesIndex(profile->species[k]) != Cantera::npos) {
+          flame.setInitialGuess(profile->species[k], locs, profile->Y[k]);
+        }
+      }
+    }
+
     inlet->setMoleFractions(x.data());
     inlet->setMdot(mdot);
     inlet->setTemperature(temperature);
@@ -181,6 +386,18 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
     flow->solveEnergyEqn();
 
     flame.solve(loglevel, refine_grid);
+    if (stats != nullptr) {
+      stats->grid_points = flow->nPoints();
+      for (auto count : flame.jacobianCountStats()) {
+        stats->jacobian_evaluations += count;
+      }
+      for (auto count : flame.evalCountStats()) {
+        stats->function_evaluations += count;
+      }
+      for (auto count : flame.timeStepStats()) {
+        stats->time_steps += count;
+      }
+    }
     // double flameSpeed_mix =
     //     flame.value(flowdomain, flow->componentIndex("velocity"), 0);
     // // print("Flame speed with mixture-averaged transport: {} m/s\n",
@@ -281,32 +498,265 @@ thermo_state flamespeed(std::shared_ptr<Cantera::Solution> sol,
       //           << " max normalized rate = " << Rmax[i] << "\n";
     }
 
+    double dTdz_max = 0.0;
+    for (size_t n = 1; n < zvec.size(); n++) {
+      dTdz_max = std::max(dTdz_max, (Tvec[n] - Tvec[n - 1]) / (zvec[n] - zvec[n - 1]));
+    }
+
     state.flamespeed = Uvec[0];
     state.Tmax       = T_max;
     state.zmax       = z_max;
+    state.thickness  = dTdz_max > 0.0 ? (Tvec.back() - Tvec.front()) / dTdz_max : 0.0;
+
+    if (profile != nullptr) {
+      profile->z = zvec;
+      profile->T = Tvec;
+      profile->u = Uvec;
+      profile->species.resize(nsp);
+      profile->Y.assign(nsp, std::vector<double>(flow->nPoints()));
+      for (size_t k = 0; k < nsp; k++) {
+        profile->species[k] = gas->speciesName(k);
+        for (size_t n = 0; n < flow->nPoints(); n++) {
+          profile->Y[k][n] = flame.value(flowdomain, flow->componentIndex(profile->species[k]), n);
+        }
+      }
+    }
 
+    telemetry().record_solve(solve_seconds(), state.flamespeed > 0.0, flow->nPoints());
     return state;
   } catch (Cantera::CanteraError& err) {
     std::cerr << err.what() << std::endl;
+    telemetry().record_solve(solve_seconds(), false, 0);
     return state;
   }
   return state;
 }
 
+// Cache das avaliações da redução, por conjunto de reações ativas: bitset sobre as reações do
+// mecanismo de origem (em hexadecimal) -> thermo_state e pesos das reações (índice de origem ->
+// peso). Fica em memória e é acrescentado a um arquivo texto, uma linha por avaliação, para que
+// outras reduções com o mesmo mecanismo e a mesma chama (outras tolerâncias ou
+// minimum_reaction_weight) reaproveitem as chamas já resolvidas.
+class reduction_cache {
+ public:
+  struct entry {
+    thermo_state state;
+    std::map<size_t, double> weights;  // Vazio se a chama não convergiu
+  };
+
+  explicit reduction_cache(const std::string& path) : path_(path) {
+    std::ifstream in(path_);
+    for (std::string line; std::getline(in, line);) {
+      std::istringstream stream(line);
+      std::string key;
+      entry value;
+      size_t n = 0;
+      stream >> key >> value.state.flamespeed >> value.state.Tad >> value.state.Tmax >>
+          value.state.zmax >> value.state.thickness >> n;
+      for (size_t r = 0; r < n && stream; r++) {
+        size_t index;
+        char colon;
+        double weight;
+        stream >> index >> colon >> weight;
+        value.weights[index] = weight;
+      }
+      if (stream) {
+        entries_[key] = value;
+      }
+    }
+  }
+
+  static std::string key(const std::set<size_t>& active, size_t n_reactions) {
+    std::vector<uint8_t> nibbles((n_reactions + 3) / 4, 0);
+    for (auto index : active) {
+      nibbles[index / 4] |= static_cast<uint8_t>(1u << (index % 4));
+    }
+    std::string hex;
+    for (auto nibble : nibbles) {
+      hex += "0123456789abcdef"[nibble];
+    }
+    return hex;
+  }
+
+  const entry* find(const std::string& key) const {
+    auto it = entries_.find(key);
+    return it == entries_.end() ? nullptr : &it->second;
+  }
+
+  void store(const std::string& key, const entry& value) {
+    entries_[key] = value;
+    std::ofstream out(path_, std::ios::app);
+    out.precision(17);
+    out << key << " " << value.state.flamespeed << " " << value.state.Tad << " "
+        << value.state.Tmax << " " << value.state.zmax << " " << value.state.thickness << " "
+        << value.weights.size();
+    for (const auto& [index, weight] : value.weights) {
+      out << " " << index << ":" << weight;
+    }
+    out << "\n";
+  }
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  std::string path_;
+  std::unordered_map<std::string, entry> entries_;
+};
+
+// FNV-1a de 64 bits: identifica o contexto do cache (mecanismo de origem + parâmetros da chama)
+// de forma estável entre execuções
+uint64_t fnv1a(const std::string& text, uint64_t hash = 14695981039346656037ull) {
+  for (unsigned char c : text) {
+    hash = (hash ^ c) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Objetivo da redução: tolerância absoluta para cada grandeza que uma única chama já fornece
+// (thermo_state); tolerância <= 0 desliga a grandeza. O erro de cada grandeza é normalizado pela
+// sua tolerância, de modo que as tolerâncias fazem o papel de pesos; o candidato é rejeitado na
+// primeira grandeza com erro normalizado >= 1.
+struct reduction_objective {
+  double flamespeed = 0.01;  // m/s
+  double Tad        = 0.0;   // K
+  double Tmax       = 0.0;   // K
+  double zmax       = 0.0;   // m
+  double thickness  = 0.0;   // m
+
+  static constexpr const char* names[5] = {"flamespeed", "Tad", "Tmax", "zmax", "thickness"};
+
+  // |a - b| / tolerância por grandeza, na ordem de names (0 para grandezas desligadas)
+  std::array<double, 5> errors(const thermo_state& a, const thermo_state& b) const {
+    const double tolerances[5] = {flamespeed, Tad, Tmax, zmax, thickness};
+    const double delta[5]      = {a.flamespeed - b.flamespeed, a.Tad - b.Tad, a.Tmax - b.Tmax,
+                                  a.zmax - b.zmax, a.thickness - b.thickness};
+    std::array<double, 5> result{};
+    for (int q = 0; q < 5; q++) {
+      result[q] = tolerances[q] > 0.0 ? std::abs(delta[q]) / tolerances[q] : 0.0;
+    }
+    return result;
+  }
+
+  // Maior erro normalizado (o candidato é aceito enquanto fica abaixo de 1)
+  double error(const thermo_state& a, const thermo_state& b) const {
+    auto e = errors(a, b);
+    return *std::max_element(e.begin(), e.end());
+  }
+
+  // Primeira grandeza violada, ou "" se todas estão dentro da tolerância
+  std::string violation(const thermo_state& value, const thermo_state& baseline) const {
+    auto e = errors(value, baseline);
+    for (int q = 0; q < 5; q++) {
+      if (e[q] >= 1.0) {
+        return names[q];
+      }
+    }
+    return "";
+  }
+};
+
+// Preditor do erro da redução: estima a variação do erro normalizado do objetivo em cada remoção
+// pela soma dos pesos das reações removidas, com a sensibilidade medida nos passos resolvidos
+// (variação do erro / soma dos pesos). A chama só é resolvida quando o erro previsto se aproxima da
+// tolerância ou a cada verify_interval passos; se a verificação estourar a tolerância, a redução
+// volta ao último mecanismo verificado e segue resolvendo todos os passos.
+struct reduction_predictor {
+  bool enabled          = true;
+  int calibration_steps = 3;    // Passos resolvidos antes de confiar na sensibilidade
+  int verify_interval   = 10;   // Máximo de passos previstos entre duas soluções
+  double solve_fraction = 0.5;  // Resolve quando o erro previsto passa desta fração da tolerância
+  double safety         = 2.0;  // Multiplica a sensibilidade medida
+};
+
 template <typename Function, typename... Args>
 Cantera::AnyMap mechanism_reduction(std::shared_ptr<Cantera::Solution> sol_complete,
-                                    double tolerance_value,
+                                    const reduction_objective& objective,
                                     int max_reactions,
                                     double minimum_reaction_weight,
+                                    const reduction_predictor& predictor,
                                     Function function_reference,
                                     Args... args) {
   std::multimap<std::string, std::pair<std::string, double>> Reactions;
 
-  auto value_baseline =
-      function_reference(sol_complete,
-                         args...,
-                         Reactions);  // TODO: Esse Reactions aqui pode quebrar implementações
+  // Mecanismo de origem e índice de cada reação, para gravar cada passo como as reações removidas
+  // em relação a ele (mechanism_tier reconstrói qualquer passo sem refazer a redução) e para as
+  // chaves do cache
+  auto kinetics_complete = sol_complete->kinetics();
+  std::vector<std::string> source_yaml;
+  std::map<std::string, size_t> source_index;
+  std::set<size_t> present;
+  std::ostringstream context;
+  context.precision(17);
+  for (size_t i = 0; i < kinetics_complete->nReactions(); i++) {
+    source_yaml.push_back(kinetics_complete->reaction(i)->input.toYamlString());
+    if (!source_index.emplace(reaction_key(source_yaml.back()), i).second) {
+      throw std::runtime_error("mechanism_reduction: reações idênticas no mecanismo de origem:\n" +
+                               source_yaml.back());
+    }
+    present.insert(i);
+    context << source_yaml.back();
+  }
+  ((context << ";" << args), ...);
+
+  // Índice na origem de uma reação do mecanismo atual. Uma reação sem correspondência sairia do
+  // conjunto presente e seria registrada como removida (no log e na chave do cache) sem ter sido.
+  auto source_of = [&](const std::string& reaction_yaml) {
+    auto source = source_index.find(reaction_key(reaction_yaml));
+    if (source == source_index.end()) {
+      throw std::runtime_error("mechanism_reduction: reação sem correspondência no mecanismo de "
+                               "origem:\n" + reaction_yaml);
+    }
+    return source->second;
+  };
+
+  std::ostringstream cache_name;
+  cache_name << "output/reduction_cache_" << std::hex << fnv1a(context.str()) << ".txt";
+  reduction_cache cache(cache_name.str());
+
+  // Conjunto já avaliado: pesos de Reactions vêm do cache (ou Reactions é montado a partir do
+  // mecanismo de origem, na linha de base); chama que não convergiu deixa Reactions vazio, como
+  // em flamespeed()
+  auto apply_cached = [&](const reduction_cache::entry& cached) {
+    std::cout << "Cached evaluation (" << present.size() << " reactions, " << cache.size()
+              << " in cache)\n";
+    if (Reactions.empty()) {
+      for (auto index : present) {
+        Reactions.insert({kinetics_complete->reaction(index)->equation(),
+                          {source_yaml[index], 0.0}});
+      }
+    }
+    for (auto& [equation, rxn] : Reactions) {
+      auto source = source_of(rxn.first);
+      if (cached.weights.count(source)) {
+        rxn.second = cached.weights.at(source);
+      }
+    }
+    if (cached.weights.empty()) {
+      Reactions.clear();
+    }
+    return cached.state;
+  };
+  auto store_cached = [&](const thermo_state& state) {
+    reduction_cache::entry value{state, {}};
+    for (const auto& [equation, rxn] : Reactions) {
+      value.weights[source_of(rxn.first)] = rxn.second;
+    }
+    cache.store(reduction_cache::key(present, source_yaml.size()), value);
+  };
+
+  thermo_state value_baseline;
+  if (auto cached = cache.find(reduction_cache::key(present, source_yaml.size()))) {
+    value_baseline = apply_cached(*cached);
+  } else {
+    value_baseline =
+        function_reference(sol_complete,
+                           args...,
+                           Reactions,
+                           nullptr,
+                           nullptr);  // TODO: Esse Reactions aqui pode quebrar implementações
                                       // futuras, por isso precisa de uma solução melhor
+    store_cached(value_baseline);
+  }
 
   // how to get phase definition from existing Solution object
   // TODO: maybe pick direct from gri30.yaml instead? need test
@@ -333,18 +783,48 @@ Cantera::AnyMap mechanism_reduction(std::shared_ptr<Cantera::Solution> sol_compl
   Cantera::AnyMap rootNode;
   Cantera::AnyMap rootNode_new;
 
-  auto value_diff = std::abs(value_new - value_baseline);
-  
+  auto value_diff          = std::abs(value_new - value_baseline);
+  double objective_error   = 0.0;
+  std::string violated;
+
+  std::vector<Cantera::AnyMap> source_reactions;
+  for (const auto& yaml : source_yaml) {
+    source_reactions.push_back(Cantera::AnyMap::fromYamlString(yaml));
+  }
+  std::ofstream source_out("output/reduction_source.yaml", std::ios::trunc);
+  source_out << mechanism_map(phaseNode, species, source_reactions).toYamlString();
+  source_out.close();
+
   std::ofstream reduction_log("output/reaction_reduction.csv", std::ios::trunc);
-  reduction_log << "num_reactions,value_diff,value_baseline,ratio\n";
-  reduction_log << Reactions.size() << "," << value_diff << "," << value_baseline << "," << (value_baseline != 0 ? value_diff / value_baseline : 0) << "\n";
-  
-  while ((value_diff < tolerance_value) and (Reactions.size() > 0)) {
+  reduction_log << "num_reactions,value_diff,value_baseline,ratio,removed,solved,objective_error,violated,rejected\n";
+  reduction_log << Reactions.size() << "," << value_diff << "," << value_baseline << "," << (value_baseline != 0 ? value_diff / value_baseline : 0) << ",,1,0,,0\n";
+
+  // Último mecanismo resolvido dentro da tolerância, para onde a redução volta se a previsão falhar
+  struct verified_state {
+    std::multimap<std::string, std::pair<std::string, double>> reactions;
+    Cantera::AnyMap rootNode;
+    std::set<size_t> present;
+    thermo_state value;
+    double value_diff;
+    double objective_error;
+  };
+  verified_state verified{Reactions, rootNode_new, present, value_baseline, value_diff, 0.0};
+  bool predicting           = predictor.enabled;
+  int solved_steps          = 0;
+  int steps_since_solve     = 0;
+  double weight_since_solve = 0.0;
+  double measured_change    = 0.0;  // Soma das variações do erro normalizado nos passos resolvidos
+  double measured_weight    = 0.0;  // Soma dos pesos removidos nesses passos
+  std::vector<std::string> predicted_rows;  // Gravadas só depois de verificadas
+
+  while (violated.empty() and (Reactions.size() > 0)) {
     rootNode = rootNode_new;
+    double removed_weight = 0.0;
     // TODO: Remove reactions with weight below minimum_reaction_weight
     for (auto it = Reactions.begin(); it != Reactions.end();) {
       if (it->second.second < minimum_reaction_weight) {
         std::cout << "Removing reaction with weight: " << it->second.second << "\n";
+        removed_weight += it->second.second;
 
         if (Reactions.count(it->first) == 2) {
           auto equation = it->first;
@@ -367,6 +847,7 @@ Cantera::AnyMap mechanism_reduction(std::shared_ptr<Cantera::Solution> sol_compl
     }
 
     std::cout << "Reactions remaining: " << Reactions.size() << "\n";
+    telemetry().reduction_depth.store(static_cast<int64_t>(Reactions.size()), std::memory_order_relaxed);
 
     auto min_reaction =
         std::min_element(Reactions.begin(), Reactions.end(), [](const auto& a, const auto& b) {
@@ -377,6 +858,7 @@ Cantera::AnyMap mechanism_reduction(std::shared_ptr<Cantera::Solution> sol_compl
     if (min_reaction != Reactions.end()) {
       std::cout << "Rate: " << min_reaction->second.second
                 << "  Reaction: " << min_reaction->second.first << "\n";
+      removed_weight += min_reaction->second.second;
 
       if (Reactions.count(min_reaction->first) == 2) {
         auto equation = min_reaction->first;
@@ -396,30 +878,109 @@ Cantera::AnyMap mechanism_reduction(std::shared_ptr<Cantera::Solution> sol_compl
     }
 
     std::vector<Cantera::AnyMap> reactionDefs;
+    std::set<size_t> remaining;
     for (auto rxn : Reactions) {
       Cantera::AnyMap rxn_data = Cantera::AnyMap::fromYamlString(rxn.second.first);
 
       reactionDefs.push_back(rxn_data);
+
+      remaining.insert(source_of(rxn.second.first));
+    }
+    std::string removed;
+    for (auto index : present) {
+      if (!remaining.count(index)) {
+        removed += (removed.empty() ? "" : " ") + std::to_string(index);
+      }
     }
+    present = remaining;
 
     rootNode_new                = mechanism_map(phaseNode, species, reactionDefs);
 
     std::string santa_gambiarra = rootNode_new.toYamlString();  // para forçar o formato certo
 
+    std::ostringstream row;
+    row << reactionDefs.size() << ",";
+    auto log_row = [&](double diff, double error, bool solved) {
+      row << diff << "," << value_baseline << "," << (value_baseline != 0 ? diff / value_baseline : 0) << "," << removed << "," << solved << "," << error << "," << violated << "," << !violated.empty() << "\n";
+    };
+
+    // Previsão: erro verificado + sensibilidade * pesos removidos desde a última solução
+    steps_since_solve++;
+    weight_since_solve += removed_weight;
+    auto cached = cache.find(reduction_cache::key(present, source_yaml.size()));
+    if (predicting && solved_steps >= predictor.calibration_steps && measured_weight > 0.0 &&
+        steps_since_solve < predictor.verify_interval && !Reactions.empty() && cached == nullptr) {
+      double predicted_error = verified.objective_error + predictor.safety * measured_change /
+                                                             measured_weight * weight_since_solve;
+      if (predicted_error < predictor.solve_fraction) {
+        std::cout << "Predicted objective error: " << predicted_error << " (solve skipped)\n";
+        // Limite superior de |delta S_L| implicado pelo erro previsto
+        double predicted_diff = objective.flamespeed > 0.0
+                                    ? std::max(verified.value_diff, predicted_error * objective.flamespeed)
+                                    : verified.value_diff;
+        log_row(predicted_diff, predicted_error, false);
+        predicted_rows.push_back(row.str());
+        continue;
+      }
+    }
+
     // std::ofstream out(
     //     "/home/Shinmen/Workspace Cloud/flame-speed/modified_mechanism.yaml");
     // out << rootNode.toYamlString();
 
-    const Cantera::AnyMap& phaseNode_new = rootNode_new.at("phases").getMapWhere("name", "gri30");
+    if (cached != nullptr) {
+      value_new = apply_cached(*cached);
+    } else {
+      const Cantera::AnyMap& phaseNode_new = rootNode_new.at("phases").getMapWhere("name", "gri30");
 
-    auto sol_new = Cantera::newSolution(phaseNode_new, rootNode_new, "mixture-averaged");
+      auto sol_new = Cantera::newSolution(phaseNode_new, rootNode_new, "mixture-averaged");
 
-    // sol_new, temperature, pressure, uin, phi,                                   refine_grid,
-    // loglevel, Reactions
-    value_new = function_reference(sol_new, args..., Reactions);
-    value_diff = std::abs(value_new - value_baseline);
-    reduction_log << Reactions.size() << "," << value_diff << "," << value_baseline << "," << (value_baseline != 0 ? value_diff / value_baseline : 0) << "\n";
+      // sol_new, temperature, pressure, uin, phi,                                   refine_grid,
+      // loglevel, Reactions
+      value_new = function_reference(sol_new, args..., Reactions, nullptr, nullptr);
+      store_cached(value_new);
+    }
+    value_diff      = std::abs(value_new - value_baseline);
+    objective_error = objective.error(value_new, value_baseline);
+    violated        = objective.violation(value_new, value_baseline);
+    if (!violated.empty()) {
+      std::cout << "Rejected: " << violated << " out of tolerance\n";
+    }
+
+    if (!violated.empty() && steps_since_solve > 1) {
+      // A previsão deixou passar: volta ao último mecanismo verificado e resolve todo passo
+      std::cout << "Verification failed (objective error " << objective_error << "), back to "
+                << verified.reactions.size() << " reactions\n";
+      Reactions          = verified.reactions;
+      rootNode_new       = verified.rootNode;
+      present            = verified.present;
+      value_diff         = verified.value_diff;
+      objective_error    = verified.objective_error;
+      violated.clear();
+      predicting         = false;
+      steps_since_solve  = 0;
+      weight_since_solve = 0.0;
+      predicted_rows.clear();
+      continue;
+    }
 
+    solved_steps++;
+    measured_change += objective.error(value_new, verified.value);
+    measured_weight += weight_since_solve;
+    for (const auto& predicted_row : predicted_rows) {
+      reduction_log << predicted_row;
+    }
+    predicted_rows.clear();
+    log_row(value_diff, objective_error, true);
+    reduction_log << row.str();
+
+    // O candidato rejeitado encerra a redução sem virar o último aceito
+    if (violated.empty()) {
+      verified = {Reactions, rootNode_new, present, value_new, value_diff, objective_error};
+      telemetry().best_error.store(objective_error, std::memory_order_relaxed);
+    }
+    steps_since_solve  = 0;
+    weight_since_solve = 0.0;
   }
   reduction_log.close();
   return rootNode;
@@ -15,20 +15,27 @@
 #include "cantera/thermo/Species.h"
 #include "cantera/transport/TransportData.h"
 #include "lib.h"
-
-struct output {
-  double ratio_fuel_ox;
-  double speed_flame_reduced;
-  double temperature_ad_reduced;
-  double temperature_max_reduced;
-  double z_t_max_reduced;
-  double speed_flame_full;
-  double temperature_ad_full;
-  double temperature_max_full;
-  double z_t_max_full;
-};
+#include "qssa.h"
 
 int main(int argc, char** argv) {
+  // --telemetry-port N: contadores de progresso em JSON em http://localhost:N (telemetry.h)
+  std::unique_ptr<telemetry_server> telemetry_endpoint;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--telemetry-port") {
+      try {
+        telemetry_endpoint = std::make_unique<telemetry_server>(std::stoi(argv[i + 1]));
+      } catch (std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return 1;
+      }
+      std::cout << "Telemetry: http://localhost:" << argv[i + 1] << std::endl;
+    } else {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    }
+  }
+
   int loglevel         = 0;
   bool refine_grid     = true;
   auto tolerance_speed = 0.01;  // m/s
@@ -72,10 +79,19 @@ int main(int argc, char** argv) {
 
   // Verify if file doesn't exist
   if (!std::filesystem::exists(output_dir + "/modified_mechanism.yaml")) {
+    // S_L decide a tolerância principal; as demais grandezas saem da mesma chama
+    reduction_objective objective;
+    objective.flamespeed = tolerance_speed;
+    objective.Tad        = 5.0;   // K
+    objective.Tmax       = 10.0;  // K
+    objective.zmax       = 2e-3;  // m
+    objective.thickness  = 2e-5;  // m
+
     auto rootNode = mechanism_reduction(sol_complete,
-                                        tolerance_speed,
+                                        objective,
                                         20,    // maximum of 400 reactions
                                         0.001,  // 0.1% tolerance for reaction rates
+                                        reduction_predictor{},
                                         flamespeed,
                                         temperature,
                                         pressure,
@@ -90,8 +106,63 @@ int main(int argc, char** argv) {
     out << rootNode.toYamlString();
   }
 
+  // Etapa QSSA sobre o mecanismo reduzido, na mistura estequiométrica: qssa_mechanism.yaml (sem as
+  // espécies QSS) validado contra o S_L do mecanismo completo, com a mesma tolerância da redução
+  if (!std::filesystem::exists(output_dir + "/qssa_closure.yaml")) {
+    auto sol_reduced =
+        Cantera::newSolution(output_dir + "/modified_mechanism.yaml", "gri30", "mixture-averaged");
+    flame_profile profile;
+    auto state = flamespeed(sol_reduced,
+                            temperature,
+                            pressure,
+                            uin,
+                            mixture_fraction_stoichiometric,
+                            fuel,
+                            oxidizer,
+                            refine_grid,
+                            loglevel,
+                            Reactions,
+                            &profile);
+
+    qssa_criteria criteria;
+    criteria.tolerance_speed = tolerance_speed;
+    criteria.reference_speed = flow_complete.flamespeed;
+    auto qssa                = qssa_reduction(sol_reduced,
+                                              state,
+                                              profile,
+                                              pressure,
+                                              criteria,
+                                              flamespeed,
+                                              temperature,
+                                              pressure,
+                                              uin,
+                                              mixture_fraction_stoichiometric,
+                                              fuel,
+                                              oxidizer,
+                                              refine_grid,
+                                              loglevel);
+    write_qssa_closure(sol_reduced, qssa, output_dir + "/qssa_closure.yaml");
+    if (!qssa.species.empty()) {
+      std::ofstream out(output_dir + "/qssa_mechanism.yaml");
+      out << qssa.mechanism.toYamlString();
+    }
+
+    std::cout << "QSSA: " << qssa.species.size() << " espécies em estado quase estacionário, "
+              << sol_reduced->thermo()->nSpecies() - qssa.species.size()
+              << " transportadas; S_L = " << qssa.flamespeed_solved << " m/s (completo "
+              << flow_complete.flamespeed << " m/s, reduzido " << qssa.flamespeed << " m/s)"
+              << std::endl;
+  }
+
   std::vector<output> results;
 
+  // Chamas que faltam na varredura (completo e reduzido por ponto, mais o estequiométrico)
+  int64_t sweep_flames = 2;
+  for (auto mixture_fraction = 0.00; mixture_fraction <= 0.20; mixture_fraction += 0.005) {
+    sweep_flames += 2;
+  }
+  telemetry().queue_depth.store(sweep_flames, std::memory_order_relaxed);
+
   for (auto mixture_fraction = 0.00; mixture_fraction <= 0.20; mixture_fraction += 0.005) {
     auto sol_complete = Cantera::newSolution("gri30.yaml", "gri30", "mixture-averaged");
 
@@ -112,6 +183,7 @@ int main(int argc, char** argv) {
       std::cout << err.what() << std::endl;
       flow_complete = {0.0, 0.0, 0.0, 0.0};
     }
+    telemetry().queue_depth.fetch_sub(1, std::memory_order_relaxed);
 
     auto sol_reduced =
         Cantera::newSolution(output_dir + "/modified_mechanism.yaml", "gri30", "mixture-averaged");
@@ -131,6 +203,7 @@ int main(int argc, char** argv) {
       std::cout << err.what() << std::endl;
       flow_reduced = {0.0, 0.0, 0.0, 0.0};
     }
+    telemetry().queue_depth.fetch_sub(1, std::memory_order_relaxed);
 
     results.push_back({mixture_fraction,
                        flow_reduced.flamespeed,
@@ -159,6 +232,7 @@ int main(int argc, char** argv) {
     std::cout << err.what() << std::endl;
     flow_complete = {0.0, 0.0, 0.0, 0.0};
   }
+  telemetry().queue_depth.fetch_sub(1, std::memory_order_relaxed);
 
   auto sol_reduced =
       Cantera::newSolution(output_dir + "/modified_mechanism.yaml", "gri30", "mixture-averaged");
@@ -178,6 +252,7 @@ int main(int argc, char** argv) {
     std::cout << err.what() << std::endl;
     flow_reduced = {0.0, 0.0, 0.0, 0.0};
   }
+  telemetry().queue_depth.fetch_sub(1, std::memory_order_relaxed);
 
   results.push_back({mixture_fraction_stoichiometric,
                      flow_reduced.flamespeed,
@@ -189,51 +264,15 @@ int main(int argc, char** argv) {
                      flow_complete.Tmax,
                      flow_complete.zmax});
 
-  //  sort results by mixture fraction
-  std::sort(results.begin(), results.end(), [](const output& a, const output& b) {
-    return a.ratio_fuel_ox < b.ratio_fuel_ox;
-  });
-
   auto num_reactions_reduced =
       Cantera::newSolution(output_dir + "/modified_mechanism.yaml", "gri30", "mixture-averaged")
           ->kinetics()
           ->nReactions();
 
-  std::ofstream out_data(output_dir + "/flame_speed_data.csv");
-  out_data << "Mixture fraction, Equivalence ratio (reduced mechanism " << num_reactions_reduced
-           << "), "
-              "Flame Speed (reduced mechanism "
-           << num_reactions_reduced
-           << ") [m/s], "
-              "Adiabatic flame temperature (reduced mechanism "
-           << num_reactions_reduced
-           << ") [K], "
-              "Maximum temperature (reduced mechanism "
-           << num_reactions_reduced
-           << ") [K], "
-              "Z_max (reduced mechanism "
-           << num_reactions_reduced
-           << ") [m], "
-              "Ignition delay time (reduced mechanism "
-           << num_reactions_reduced
-           << ") [s], "
-              "Flame Speed (complete mechanism) [m/s], "
-              "Adiabatic flame temperature (complete mechanism) [K], "
-              "Maximum temperature (complete mechanism) [K], "
-              "Z_max (complete mechanism) [m], "
-              "Ignition delay time (complete mechanism) [s]\n";
-  for (auto r : results) {
-    auto new_phi                     = r.ratio_fuel_ox / (mixture_fraction_stoichiometric);
-
-    auto ignition_delay_time_reduced = r.z_t_max_reduced / (r.speed_flame_reduced);
-    auto ignition_delay_time_full    = r.z_t_max_full / (r.speed_flame_full);
-
-    out_data << r.ratio_fuel_ox << "," << new_phi << "," << r.speed_flame_reduced << ","
-             << r.temperature_ad_reduced << "," << r.temperature_max_reduced << ","
-             << r.z_t_max_reduced << "," << ignition_delay_time_reduced << "," << r.speed_flame_full
-             << "," << r.temperature_ad_full << "," << r.temperature_max_full << ","
-             << r.z_t_max_full << "," << ignition_delay_time_full << "\n";
-  }
+  write_flame_speed_data(output_dir + "/flame_speed_data.csv",
+                         results,
+                         mixture_fraction_stoichiometric,
+                         num_reactions_reduced);
 
   std::cout << "Data written to flame_speed_data.csv" << std::endl;
 
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Executa function(i) para i em [0, n) em um conjunto de threads. As tarefas são distribuídas
+// dinamicamente (contador atômico), então chamas lentas (ex.: perto do limite pobre) não deixam as
+// outras threads paradas esperando. threads == 0 usa std::thread::hardware_concurrency().
+template <typename Function>
+void parallel_for(size_t n, unsigned threads, Function&& function) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = static_cast<unsigned>(std::min<size_t>(threads, n));
+
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> workers;
+  for (unsigned t = 0; t < threads; t++) {
+    workers.emplace_back([&]() {
+      for (size_t i = next++; i < n; i = next++) {
+        function(i);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
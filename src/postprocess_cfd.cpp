@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "flame_front.h"
+#include "parallel.h"
+
+// Extrai a posição da frente de chama e S_L de todos os diretórios de tempo de um caso do OpenFOAM
+// (Plano.md, seção 8.1), sem ParaView. Os processadores e os tempos são lidos em paralelo; a
+// amostragem no eixo está em flame_front.h.
+//
+// Uso: postprocess_cfd [--case $FOAM_RUN/canal] [--method threshold|qdot] [--threshold 1500]
+//                      [--threads N] [--output <caso>/flame.csv]
+
+int main(int argc, char** argv) {
+  std::filesystem::path case_dir;
+  if (const char* foam_run = std::getenv("FOAM_RUN")) {
+    case_dir = std::filesystem::path(foam_run) / "canal";
+  }
+  std::string method = "threshold";
+  double threshold   = 1500.0;  // K
+  unsigned threads   = 0;
+  std::filesystem::path output_path;
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg   = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--case") {
+      case_dir = value;
+    } else if (arg == "--method" && (value == "threshold" || value == "qdot")) {
+      method = value;
+    } else if (arg == "--threshold") {
+      threshold = std::stod(value);
+    } else if (arg == "--threads") {
+      threads = static_cast<unsigned>(std::stoi(value));
+    } else if (arg == "--output") {
+      output_path = value;
+    } else {
+      std::cerr << "Unknown option: " << arg << " " << value << std::endl;
+      return 1;
+    }
+  }
+  if (output_path.empty()) {
+    output_path = case_dir / "flame.csv";
+  }
+
+  std::vector<flame_front> fronts;
+  try {
+    flame_axis axis(case_dir, threads);
+    auto times = axis.times();
+    if (times.empty()) {
+      std::cerr << "Erro: nenhum diretório de tempo com T em " << axis.domains().front()
+                << std::endl;
+      return 1;
+    }
+
+    // Uma tarefa por tempo; com menos tempos que domínios, os domínios também se dividem
+    unsigned domain_threads = times.size() < axis.domains().size() ? threads : 1;
+    fronts.resize(times.size());
+    std::string error;
+    std::mutex error_mutex;
+    parallel_for(times.size(), threads, [&](size_t t) {
+      try {
+        fronts[t] = axis.measure(times[t], method, threshold, domain_threads);
+      } catch (std::exception& err) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        error = err.what();
+      }
+    });
+    if (!error.empty()) {
+      throw std::runtime_error(error);
+    }
+    write_flame_csv(output_path, fronts);
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+
+  const auto& last = fronts.back();
+  std::cout << "t = " << last.time << " s: x_flame = " << last.x_flame
+            << " m, S_L = " << last.flamespeed << " m/s, T_max = " << last.T_max << " K ("
+            << fronts.size() << " tempos em " << output_path << ")" << std::endl;
+  return 0;
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/AnyMap.h"
+#include "cantera/base/Solution.h"
+#include "cantera/kinetics/Reaction.h"
+#include "lib.h"
+
+// Etapa QSSA depois da redução de reações: escolhe espécies em estado quase estacionário a partir
+// do perfil da chama 1-D, gera o fechamento algébrico delas e um mecanismo com menos espécies
+// transportadas, validado resolvendo a chama com ele.
+//
+// Critérios, avaliados na zona de reação (liberação de calor >= 1% do pico):
+//   - escala de tempo química tau_k = C_k / D_k (concentração / taxa de destruição) pequena em
+//     relação ao tempo de residência na chama, tau_flame = espessura / S_L;
+//   - fração mássica máxima pequena (radicais, não reagentes nem produtos principais).
+//
+// Fechamento: C_k = P_k / (D_k / C_k), com P_k e D_k as taxas de criação e destruição de k; como
+// D_k é (aproximadamente) linear em C_k, as espécies QSS acopladas são resolvidas por ponto fixo.
+//
+// Triagem: as concentrações do fechamento substituem as do perfil e a liberação de calor integrada
+// é comparada com a original. Com S_L^2 proporcional a ela (Zeldovich), a estimativa de S_L precisa
+// ficar dentro da tolerância; se não ficar, a espécie com maior erro de fechamento sai do conjunto.
+//
+// Validação: o Flow1D do Cantera não aceita espécies algébricas, então o mecanismo validado é o
+// reduzido sem as espécies QSS e sem as reações em que elas reagem ou são produzidas (eficiências
+// de terceiro corpo delas são apagadas). A chama é resolvida com ele (a mesma função da redução) e
+// S_L precisa ficar dentro de tolerance_speed do S_L de referência; se não ficar, a pior espécie
+// sai do conjunto e triagem e validação se repetem.
+
+struct qssa_criteria {
+  double max_timescale_ratio = 1e-2;  // tau_k / tau_flame
+  double max_mass_fraction   = 1e-3;
+  double tolerance_speed     = 0.01;  // m/s, como na redução
+  double reference_speed     = 0.0;   // m/s, S_L de referência (0: o da chama do perfil)
+};
+
+struct qss_species {
+  std::string name;
+  double timescale;      // s, máximo na zona de reação
+  double max_Y;          // Fração mássica máxima no perfil
+  double closure_error;  // max |C_qss - C| / C na zona de reação
+};
+
+struct qssa_result {
+  std::vector<qss_species> species;
+  double flamespeed;           // S_L da chama do perfil
+  double flamespeed_estimate;  // Triagem: liberação de calor com o fechamento no perfil
+  double flamespeed_solved;    // S_L resolvido com o mecanismo sem as espécies QSS
+  Cantera::AnyMap mechanism;   // Mecanismo sem as espécies QSS (vazio se nenhuma passou)
+};
+
+namespace qssa_detail {
+
+// Liberação de calor volumétrica (W/m^3) no estado atual do gás
+double heat_release(std::shared_ptr<Cantera::Solution> sol) {
+  size_t nsp = sol->thermo()->nSpecies();
+  std::vector<double> wdot(nsp), h(nsp);
+  sol->kinetics()->getNetProductionRates(wdot.data());
+  sol->thermo()->getPartialMolarEnthalpies(h.data());
+  double q = 0.0;
+  for (size_t k = 0; k < nsp; k++) {
+    q -= h[k] * wdot[k];
+  }
+  return q;
+}
+
+// Concentrações de fechamento das espécies QSS (índices em qss) no estado atual; devolve o
+// maior erro relativo em relação às concentrações do perfil e deixa o gás no estado fechado
+double close_concentrations(std::shared_ptr<Cantera::Solution> sol, const std::vector<size_t>& qss) {
+  auto gas      = sol->thermo();
+  auto kinetics = sol->kinetics();
+  size_t nsp    = gas->nSpecies();
+  std::vector<double> C(nsp), creation(nsp), destruction(nsp);
+  gas->getConcentrations(C.data());
+  const auto C_profile = C;
+  const double floor   = 1e-30;  // kmol/m^3: D_k / C_k precisa de C_k > 0
+
+  for (auto k : qss) {
+    C[k] = std::max(C[k], floor);
+  }
+  for (int it = 0; it < 50; it++) {
+    gas->setConcentrations(C.data());
+    kinetics->getCreationRates(creation.data());
+    kinetics->getDestructionRates(destruction.data());
+    double change = 0.0;
+    for (auto k : qss) {
+      if (destruction[k] <= 0.0) {
+        continue;
+      }
+      double closed = std::max(creation[k] / (destruction[k] / C[k]), floor);
+      change        = std::max(change, std::abs(closed - C[k]) / closed);
+      C[k]          = closed;
+    }
+    if (change < 1e-8) {
+      break;
+    }
+  }
+  gas->setConcentrations(C.data());
+
+  double error = 0.0;
+  for (auto k : qss) {
+    if (C_profile[k] > floor) {
+      error = std::max(error, std::abs(C[k] - C_profile[k]) / C_profile[k]);
+    }
+  }
+  return error;
+}
+
+// Mecanismo de sol sem as espécies de removed e sem as reações que as têm como reagente ou produto;
+// eficiências de terceiro corpo dessas espécies são apagadas
+Cantera::AnyMap without_species(std::shared_ptr<Cantera::Solution> sol,
+                                const std::set<std::string>& removed) {
+  auto gas      = sol->thermo();
+  auto kinetics = sol->kinetics();
+
+  std::vector<Cantera::AnyMap> species;
+  std::vector<std::string> names;
+  for (size_t k = 0; k < gas->nSpecies(); k++) {
+    if (!removed.count(gas->speciesName(k))) {
+      names.push_back(gas->speciesName(k));
+      species.push_back(
+          Cantera::AnyMap::fromYamlString(gas->species(k)->parameters().toYamlString()));
+    }
+  }
+
+  std::vector<Cantera::AnyMap> reactions;
+  std::map<std::string, int> equations;
+  for (size_t r = 0; r < kinetics->nReactions(); r++) {
+    auto rxn  = kinetics->reaction(r);
+    bool uses = false;
+    for (const auto* side : {&rxn->reactants, &rxn->products}) {
+      for (const auto& [name, coefficient] : *side) {
+        uses = uses || removed.count(name);
+      }
+    }
+    if (uses) {
+      continue;
+    }
+    auto rxn_data = Cantera::AnyMap::fromYamlString(rxn->input.toYamlString());
+    if (rxn_data.hasKey("efficiencies")) {
+      auto& efficiencies = rxn_data["efficiencies"].as<Cantera::AnyMap>();
+      for (const auto& name : removed) {
+        efficiencies.erase(name);
+      }
+    }
+    equations[rxn_data["equation"].asString()]++;
+    reactions.push_back(rxn_data);
+  }
+  // Reação duplicada cujo par saiu deixa de ser "duplicate" (como na redução)
+  for (auto& rxn : reactions) {
+    if (rxn.hasKey("duplicate") && equations[rxn["equation"].asString()] < 2) {
+      rxn.erase("duplicate");
+    }
+  }
+
+  auto phaseNode = gas->input();
+  if (phaseNode.hasKey("species") && phaseNode["species"].is<std::vector<std::string>>()) {
+    phaseNode["species"] = names;
+  }
+  // Ida e volta pelo YAML para forçar o formato certo, como na redução
+  return Cantera::AnyMap::fromYamlString(
+      mechanism_map(phaseNode, species, reactions).toYamlString());
+}
+
+}  // namespace qssa_detail
+
+// profile e state: chama resolvida com flamespeed(..., &profile) no mesmo mecanismo de sol.
+// function_reference(sol, args..., reactions, profile, stats) resolve a chama de validação, como em
+// mechanism_reduction (ex.: flamespeed e os mesmos argumentos).
+template <typename Function, typename... Args>
+qssa_result qssa_reduction(std::shared_ptr<Cantera::Solution> sol,
+                           const thermo_state& state,
+                           const flame_profile& profile,
+                           double pressure,
+                           const qssa_criteria& criteria,
+                           Function function_reference,
+                           Args... args) {
+  auto gas   = sol->thermo();
+  size_t nsp = gas->nSpecies();
+  size_t np  = profile.z.size();
+  qssa_result result{{}, state.flamespeed, state.flamespeed, state.flamespeed, {}};
+  if (profile.empty() || state.flamespeed <= 0.0 || state.thickness <= 0.0) {
+    return result;
+  }
+  double tau_flame       = state.thickness / state.flamespeed;
+  double reference_speed =
+      criteria.reference_speed > 0.0 ? criteria.reference_speed : state.flamespeed;
+
+  // Estado de cada ponto do perfil na ordem de espécies de sol
+  std::vector<std::vector<double>> Y(np, std::vector<double>(nsp, 0.0));
+  for (size_t s = 0; s < profile.species.size(); s++) {
+    size_t k = gas->speciesIndex(profile.species[s]);
+    if (k == Cantera::npos) {
+      continue;
+    }
+    for (size_t n = 0; n < np; n++) {
+      Y[n][k] = profile.Y[s][n];
+    }
+  }
+  auto set_point = [&](size_t n) { gas->setState_TPY(profile.T[n], pressure, Y[n].data()); };
+
+  std::vector<double> q(np);
+  double q_peak = 0.0;
+  for (size_t n = 0; n < np; n++) {
+    set_point(n);
+    q[n]   = qssa_detail::heat_release(sol);
+    q_peak = std::max(q_peak, q[n]);
+  }
+  std::vector<size_t> zone;
+  for (size_t n = 0; n < np; n++) {
+    if (q[n] >= 0.01 * q_peak) {
+      zone.push_back(n);
+    }
+  }
+
+  // ===== Candidatas: tau_k e Y_max =====
+  std::vector<double> tau(nsp, 0.0), max_Y(nsp, 0.0);
+  std::vector<double> C(nsp), destruction(nsp);
+  for (size_t n = 0; n < np; n++) {
+    for (size_t k = 0; k < nsp; k++) {
+      max_Y[k] = std::max(max_Y[k], Y[n][k]);
+    }
+  }
+  for (auto n : zone) {
+    set_point(n);
+    gas->getConcentrations(C.data());
+    sol->kinetics()->getDestructionRates(destruction.data());
+    for (size_t k = 0; k < nsp; k++) {
+      double lifetime = destruction[k] > 0.0 ? C[k] / destruction[k]
+                                             : std::numeric_limits<double>::infinity();
+      tau[k] = std::max(tau[k], lifetime);
+    }
+  }
+
+  std::vector<size_t> candidates;
+  for (size_t k = 0; k < nsp; k++) {
+    bool inlet = Y.front()[k] > 0.0 || Y.back()[k] > criteria.max_mass_fraction;
+    if (!inlet && max_Y[k] > 0.0 && max_Y[k] < criteria.max_mass_fraction &&
+        tau[k] < criteria.max_timescale_ratio * tau_flame) {
+      candidates.push_back(k);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [&](size_t a, size_t b) {
+    return tau[a] < tau[b];
+  });
+
+  // ===== Triagem e validação; tira a pior espécie até caber =====
+  auto integrate = [&](const std::vector<double>& values) {
+    double total = 0.0;
+    for (size_t n = 1; n < np; n++) {
+      total += 0.5 * (values[n] + values[n - 1]) * (profile.z[n] - profile.z[n - 1]);
+    }
+    return total;
+  };
+  double Q                     = integrate(q);
+  const std::string phase_name = gas->input()["name"].asString();
+
+  while (!candidates.empty()) {
+    std::vector<double> q_qss(np), errors(candidates.size(), 0.0);
+    for (size_t n = 0; n < np; n++) {
+      set_point(n);
+      if (q[n] >= 0.01 * q_peak) {
+        // Erro de fechamento de cada espécie isolada, para saber qual retirar
+        for (size_t c = 0; c < candidates.size(); c++) {
+          set_point(n);
+          errors[c] = std::max(errors[c], qssa_detail::close_concentrations(sol, {candidates[c]}));
+        }
+        set_point(n);
+      }
+      qssa_detail::close_concentrations(sol, candidates);
+      q_qss[n] = qssa_detail::heat_release(sol);
+    }
+
+    double ratio               = Q > 0.0 ? integrate(q_qss) / Q : 1.0;
+    result.flamespeed_estimate = state.flamespeed * std::sqrt(std::max(ratio, 0.0));
+    bool screened =
+        std::abs(result.flamespeed_estimate - state.flamespeed) <= criteria.tolerance_speed;
+
+    if (screened) {
+      std::set<std::string> removed;
+      for (auto k : candidates) {
+        removed.insert(gas->speciesName(k));
+      }
+      auto mechanism        = qssa_detail::without_species(sol, removed);
+      const auto& phaseNode = mechanism.at("phases").getMapWhere("name", phase_name);
+      auto sol_qss          = Cantera::newSolution(phaseNode, mechanism, "mixture-averaged");
+
+      std::multimap<std::string, std::pair<std::string, double>> reactions;
+      auto solved              = function_reference(sol_qss, args..., reactions, nullptr, nullptr);
+      result.flamespeed_solved = solved.flamespeed;
+      if (solved.flamespeed > 0.0 &&
+          std::abs(solved.flamespeed - reference_speed) <= criteria.tolerance_speed) {
+        for (size_t c = 0; c < candidates.size(); c++) {
+          size_t k = candidates[c];
+          result.species.push_back({gas->speciesName(k), tau[k], max_Y[k], errors[c]});
+        }
+        result.mechanism = mechanism;
+        return result;
+      }
+    }
+    size_t worst = std::max_element(errors.begin(), errors.end()) - errors.begin();
+    std::cout << "QSSA: " << gas->speciesName(candidates[worst])
+              << " removida do conjunto (erro de fechamento " << errors[worst] << ", S_L estimado "
+              << result.flamespeed_estimate << " m/s"
+              << (screened ? ", resolvido " + std::to_string(result.flamespeed_solved) + " m/s" : "")
+              << ")" << std::endl;
+    candidates.erase(candidates.begin() + worst);
+  }
+  result.flamespeed_estimate = state.flamespeed;
+  result.flamespeed_solved   = state.flamespeed;
+  return result;
+}
+
+// Fechamento em YAML: por espécie QSS, os critérios e as reações que a produzem e a consomem
+// (índices e equações no mecanismo de sol), C_k = sum(produção) / (sum(consumo) / C_k)
+void write_qssa_closure(std::shared_ptr<Cantera::Solution> sol,
+                        const qssa_result& result,
+                        const std::string& path) {
+  auto gas      = sol->thermo();
+  auto kinetics = sol->kinetics();
+
+  std::vector<Cantera::AnyMap> species;
+  for (const auto& qss : result.species) {
+    size_t k = gas->speciesIndex(qss.name);
+    std::vector<long int> production, consumption;
+    std::vector<std::string> production_eq, consumption_eq;
+    for (size_t r = 0; r < kinetics->nReactions(); r++) {
+      bool produces = kinetics->productStoichCoeff(k, r) > 0.0;
+      bool consumes = kinetics->reactantStoichCoeff(k, r) > 0.0;
+      // Reações reversíveis atuam nos dois sentidos
+      if (produces || (consumes && kinetics->isReversible(r))) {
+        production.push_back(static_cast<long int>(r));
+        production_eq.push_back(kinetics->reaction(r)->equation());
+      }
+      if (consumes || (produces && kinetics->isReversible(r))) {
+        consumption.push_back(static_cast<long int>(r));
+        consumption_eq.push_back(kinetics->reaction(r)->equation());
+      }
+    }
+
+    Cantera::AnyMap entry;
+    entry["name"]                  = qss.name;
+    entry["timescale"]             = qss.timescale;
+    entry["max-mass-fraction"]     = qss.max_Y;
+    entry["closure-error"]         = qss.closure_error;
+    entry["production"]            = production;
+    entry["production-equations"]  = production_eq;
+    entry["consumption"]           = consumption;
+    entry["consumption-equations"] = consumption_eq;
+    species.push_back(entry);
+  }
+
+  Cantera::AnyMap rootNode;
+  rootNode["flamespeed"]          = result.flamespeed;
+  rootNode["flamespeed-estimate"] = result.flamespeed_estimate;
+  rootNode["flamespeed-solved"]   = result.flamespeed_solved;
+  rootNode["qss-species"]         = species;
+
+  std::ofstream out(path, std::ios::trunc);
+  out << rootNode.toYamlString();
+}
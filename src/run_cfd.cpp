@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flame_front.h"
+
+// Executa um caso gerado pelo generate_cfd: blockMesh -> createZones -> checkMesh -> decomposePar ->
+// foamRun -> reconstructPar, como o buildrun.sh, mas acompanhando a chama durante a simulação.
+//
+// Uso: run_cfd [--case $FOAM_RUN/canal] [--window 0.1] [--tolX 5e-4] [--tolS 0.02]
+//              [--method threshold|qdot] [--threshold 1500] [--poll 5] [--threads N]
+//
+// O log do foamRun é repassado para a saída e para logs/foamRun.log. A cada novo diretório de tempo
+// escrito, a frente de chama e S_L são medidas como no postprocess_cfd (flame_front.h). Quando, nos
+// últimos `window` segundos simulados, x_flame variou no máximo tolX (m) e S_L no máximo tolS
+// (relativo), a chama é considerada estacionária: o controlDict passa para `stopAt writeNow` e o
+// foamRun (runTimeModifiable) escreve o tempo atual e termina. O histórico fica em <caso>/flame.csv.
+
+struct run_options {
+  std::filesystem::path case_dir;
+  double window      = 0.1;   // s simulados
+  double tol_x       = 5e-4;  // m
+  double tol_s       = 0.02;  // Variação relativa de S_L
+  std::string method = "threshold";
+  double threshold   = 1500.0;  // K
+  double poll        = 5.0;     // s entre verificações dos diretórios de tempo
+  unsigned threads   = 0;
+};
+
+std::string shell_quote(const std::string& text) {
+  std::string quoted = "'";
+  for (char c : text) {
+    quoted += c == '\'' ? std::string("'\\''") : std::string(1, c);
+  }
+  return quoted + "'";
+}
+
+// Roda um utilitário do OpenFOAM no diretório do caso, com a saída em logs/<name>.log
+int run_step(const std::filesystem::path& case_dir, const std::string& name, const std::string& command) {
+  std::cout << "Running " << name << "..." << std::endl;
+  std::string line = "cd " + shell_quote(case_dir.string()) + " && " + command + " > logs/" + name +
+                     ".log 2>&1";
+  int status = std::system(line.c_str());
+  if (status != 0) {
+    std::cerr << name << " falhou (veja logs/" << name << ".log)" << std::endl;
+  }
+  return status;
+}
+
+std::string read_text(const std::filesystem::path& path) {
+  std::ifstream in(path);
+  std::stringstream buffer;
+  buffer << in.rdbuf();
+  return buffer.str();
+}
+
+int number_of_subdomains(const std::filesystem::path& case_dir) {
+  std::smatch match;
+  std::string text = read_text(case_dir / "system/decomposeParDict");
+  if (std::regex_search(text, match, std::regex(R"(numberOfSubdomains\s+(\d+)\s*;)"))) {
+    return std::stoi(match[1]);
+  }
+  return 1;
+}
+
+// Escreve em um temporário e renomeia: o foamRun nunca lê um controlDict pela metade
+bool replace_text(const std::filesystem::path& path, const std::string& text) {
+  auto temporary = path;
+  temporary += ".tmp";
+  std::ofstream out(temporary, std::ios::trunc);
+  out << text;
+  out.close();
+  std::error_code ec;
+  std::filesystem::rename(temporary, path, ec);
+  return !ec && out;
+}
+
+// Pede ao foamRun que escreva o tempo atual e termine (relido por runTimeModifiable)
+bool request_write_now(const std::filesystem::path& case_dir, const std::string& control_dict) {
+  return replace_text(case_dir / "system/controlDict",
+                      std::regex_replace(control_dict, std::regex(R"(stopAt\s+\w+\s*;)"),
+                                         "stopAt          writeNow;"));
+}
+
+// Chama estacionária: nos últimos `window` s, amplitude de x_flame <= tol_x e de S_L <= tol_s * |S_L|
+bool steady_flame(const std::vector<flame_front>& history, const run_options& options) {
+  if (history.empty()) {
+    return false;
+  }
+  double start = history.back().time - options.window;
+  if (history.front().time > start + 1e-12) {
+    return false;  // A janela ainda não foi coberta
+  }
+  double x_min = INFINITY, x_max = -INFINITY, s_min = INFINITY, s_max = -INFINITY;
+  size_t n     = 0;
+  for (auto it = history.rbegin(); it != history.rend() && it->time >= start - 1e-12; ++it) {
+    if (!std::isfinite(it->x_flame) || !std::isfinite(it->flamespeed)) {
+      return false;
+    }
+    x_min = std::min(x_min, it->x_flame);
+    x_max = std::max(x_max, it->x_flame);
+    s_min = std::min(s_min, it->flamespeed);
+    s_max = std::max(s_max, it->flamespeed);
+    n++;
+  }
+  double s_mean = 0.5 * (s_min + s_max);
+  return n >= 3 && x_max - x_min <= options.tol_x &&
+         s_max - s_min <= options.tol_s * std::abs(s_mean);
+}
+
+int main(int argc, char** argv) {
+  run_options options;
+  if (const char* foam_run = std::getenv("FOAM_RUN")) {
+    options.case_dir = std::filesystem::path(foam_run) / "canal";
+  }
+
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg   = argv[i];
+    std::string value = argv[i + 1];
+    if (arg == "--case") {
+      options.case_dir = value;
+    } else if (arg == "--window") {
+      options.window = std::stod(value);
+    } else if (arg == "--tolX") {
+      options.tol_x = std::stod(value);
+    } else if (arg == "--tolS") {
+      options.tol_s = std::stod(value);
+    } else if (arg == "--method" && (value == "threshold" || value == "qdot")) {
+      options.method = value;
+    } else if (arg == "--threshold") {
+      options.threshold = std::stod(value);
+    } else if (arg == "--poll") {
+      options.poll = std::stod(value);
+    } else if (arg == "--threads") {
+      options.threads = static_cast<unsigned>(std::stoi(value));
+    } else {
+      std::cerr << "Unknown option: " << arg << " " << value << std::endl;
+      return 1;
+    }
+  }
+  const auto& case_dir = options.case_dir;
+  if (!std::filesystem::exists(case_dir / "system/controlDict")) {
+    std::cerr << "Erro: " << case_dir << " não é um caso do OpenFOAM" << std::endl;
+    return 1;
+  }
+  std::filesystem::remove_all(case_dir / "logs");
+  std::filesystem::create_directories(case_dir / "logs");
+
+  // ===== Malha e decomposição =====
+  int np = number_of_subdomains(case_dir);
+  if (std::filesystem::exists(case_dir / "constant/polyMesh/owner")) {
+    std::cout << "Using constant/polyMesh written by generate_cfd" << std::endl;
+  } else if (run_step(case_dir, "blockMesh", "blockMesh") != 0 ||
+             run_step(case_dir, "createZones", "createZones") != 0) {
+    return 1;
+  }
+  run_step(case_dir, "checkMesh", "checkMesh");
+  if (np > 1) {
+    if (run_step(case_dir, "decomposePar", "decomposePar -force") != 0) {
+      return 1;
+    }
+  } else {
+    // processor* de uma execução anterior confundiriam a leitura dos tempos
+    for (int p = 0; std::filesystem::exists(case_dir / ("processor" + std::to_string(p))); p++) {
+      std::filesystem::remove_all(case_dir / ("processor" + std::to_string(p)));
+    }
+  }
+
+  std::unique_ptr<flame_axis> axis;
+  try {
+    axis = std::make_unique<flame_axis>(case_dir, options.threads);
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+    return 1;
+  }
+
+  // stopAt original, restaurado no fim para que o caso possa ser continuado
+  const std::string control_dict = read_text(case_dir / "system/controlDict");
+
+  // ===== Monitor: mede cada diretório de tempo completo =====
+  std::vector<flame_front> history;
+  std::vector<std::string> measured;
+  std::atomic<bool> stop_requested{false};
+  std::atomic<bool> solver_done{false};
+  std::mutex monitor_mutex;
+  std::condition_variable wake;
+
+  // Um tempo só é lido depois que o seguinte aparece (ou o solver terminou): antes disso o foamRun
+  // pode ainda estar escrevendo os campos
+  auto sample_new_times = [&](bool final) {
+    auto times = axis->times();
+    size_t complete = final ? times.size() : (times.empty() ? 0 : times.size() - 1);
+    for (size_t t = measured.size(); t < complete; t++) {
+      try {
+        history.push_back(axis->measure(times[t], options.method, options.threshold, options.threads));
+      } catch (std::exception& err) {
+        std::cerr << "Aviso: tempo " << times[t] << " ignorado: " << err.what() << std::endl;
+        flame_front missing{0.0, std::nan(""), std::nan(""), std::nan(""), 0.0};
+        parse_foam_time(times[t], missing.time);
+        history.push_back(missing);
+      }
+      measured.push_back(times[t]);
+      const auto& front = history.back();
+      std::cout << "[run_cfd] t = " << front.time << " s: x_flame = " << front.x_flame
+                << " m, S_L = " << front.flamespeed << " m/s" << std::endl;
+    }
+  };
+
+  std::thread monitor([&]() {
+    std::unique_lock<std::mutex> lock(monitor_mutex);
+    while (!solver_done) {
+      wake.wait_for(lock, std::chrono::duration<double>(options.poll));
+      if (solver_done) {
+        break;
+      }
+      sample_new_times(false);
+      if (!stop_requested && steady_flame(history, options)) {
+        std::cout << "[run_cfd] Chama estacionária por " << options.window
+                  << " s; encerrando o foamRun (stopAt writeNow)" << std::endl;
+        stop_requested = request_write_now(case_dir, control_dict);
+      }
+    }
+  });
+
+  // ===== Solver =====
+  std::string command = np > 1 ? "mpirun -np " + std::to_string(np) + " foamRun -parallel" : "foamRun";
+  std::cout << "Running " << command << "..." << std::endl;
+  std::ofstream log(case_dir / "logs/foamRun.log");
+  int solver_status = -1;
+  if (FILE* pipe = ::popen(("cd " + shell_quote(case_dir.string()) + " && " + command + " 2>&1").c_str(),
+                           "r")) {
+    char buffer[4096];
+    while (std::fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+      std::cout << buffer;
+      log << buffer;
+    }
+    solver_status = ::pclose(pipe);
+  }
+  log.close();
+  {
+    std::lock_guard<std::mutex> lock(monitor_mutex);
+    solver_done = true;
+  }
+  wake.notify_all();
+  monitor.join();
+
+  if (stop_requested) {
+    replace_text(case_dir / "system/controlDict", control_dict);
+  }
+  if (solver_status != 0) {
+    std::cerr << "foamRun terminou com status " << solver_status << " (veja logs/foamRun.log)"
+              << std::endl;
+  }
+  sample_new_times(true);
+  try {
+    write_flame_csv(case_dir / "flame.csv", history);
+  } catch (std::exception& err) {
+    std::cerr << "Erro: " << err.what() << std::endl;
+  }
+
+  if (np > 1) {
+    run_step(case_dir, "reconstructPar", "reconstructPar");
+  }
+
+  if (!history.empty()) {
+    const auto& last = history.back();
+    std::cout << (stop_requested ? "Chama estacionária" : "Fim da simulação") << " em t = "
+              << last.time << " s: x_flame = " << last.x_flame << " m, S_L = " << last.flamespeed
+              << " m/s" << std::endl;
+  }
+  std::cout << "OK" << std::endl;
+  return solver_status == 0 ? 0 : 1;
+}
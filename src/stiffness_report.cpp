@@ -0,0 +1,132 @@
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cantera/base/Solution.h"
+#include "cantera/onedim.h"
+#include "chemical_timescales.h"
+#include "lib.h"
+
+// Relatório de escalas de tempo químicas e rigidez dos mecanismos (completo, reduzido e tiers do
+// mechanism_tier), na chama 1-D estequiométrica de CH4/ar usada na redução.
+//
+// Uso: stiffness_report [--phi 1.0] [--output output] [mecanismo.yaml ...]
+//      (padrão: gri30.yaml output/modified_mechanism.yaml)
+//
+// Escreve <output>/stiffness_<mecanismo>.csv (escalas em cada ponto do perfil) e
+// <output>/stiffness_summary.csv (uma linha por mecanismo), e imprime os ajustes recomendados para
+// canal_base/constant/chemistryProperties e o passo de tempo do caso.
+
+int main(int argc, char** argv) {
+  std::string output_dir = "output";
+  double phi             = 1.0;
+  std::vector<std::string> mechanisms;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 < argc && arg == "--phi") {
+      phi = std::stod(argv[++i]);
+    } else if (i + 1 < argc && arg == "--output") {
+      output_dir = argv[++i];
+    } else if (arg.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return 1;
+    } else {
+      mechanisms.push_back(arg);
+    }
+  }
+  if (mechanisms.empty()) {
+    mechanisms = {"gri30.yaml", output_dir + "/modified_mechanism.yaml"};
+  }
+  std::filesystem::create_directories(output_dir);
+
+  // Mesma chama da redução (main.cpp)
+  int loglevel       = 0;
+  bool refine_grid   = true;
+  auto fuel          = "CH4";
+  auto oxidizer      = "O2:1, N2:3.76";
+  double temperature = 300.0;                  // K
+  double pressure    = 1.0 * Cantera::OneBar;  // Bar
+  double uin         = 0.3;                    // m/sec
+
+  std::ofstream summary_out(output_dir + "/stiffness_summary.csv", std::ios::trunc);
+  summary_out << "mechanism,n_species,n_reactions,flamespeed,tau_fast_active,tau_slow_active,"
+                 "max_stiffness,tau_flame,solver,initialChemicalTimeStep,eps,cTauChem,"
+                 "deltaT_min,deltaT_max\n";
+
+  double reference_stiffness = 0.0;
+  for (const auto& mechanism : mechanisms) {
+    std::string name = std::filesystem::path(mechanism).stem().string();
+    try {
+      auto sol = Cantera::newSolution(mechanism, "gri30", "mixture-averaged");
+      sol->thermo()->setEquivalenceRatio(phi, fuel, oxidizer);
+      double mixture_fraction = sol->thermo()->mixtureFraction(fuel, oxidizer);
+
+      std::multimap<std::string, std::pair<std::string, double>> reactions;
+      flame_profile profile;
+      auto state = flamespeed(sol,
+                              temperature,
+                              pressure,
+                              uin,
+                              mixture_fraction,
+                              fuel,
+                              oxidizer,
+                              refine_grid,
+                              loglevel,
+                              reactions,
+                              &profile);
+      if (profile.empty()) {
+        std::cerr << name << ": a chama não convergiu" << std::endl;
+        continue;
+      }
+
+      auto points = flame_timescales(sol, profile, pressure);
+      std::ofstream out(output_dir + "/stiffness_" + name + ".csv", std::ios::trunc);
+      out << "z,T,heat_release,tau_fast,tau_slow,stiffness,explosive\n";
+      for (const auto& point : points) {
+        out << point.z << "," << point.T << "," << point.heat_release << "," << point.tau_fast << ","
+            << point.tau_slow << "," << point.stiffness << "," << point.explosive << "\n";
+      }
+
+      auto summary  = summarize_stiffness(points, state);
+      auto settings = recommend_integrator(summary);
+      summary_out << name << "," << sol->thermo()->nSpecies() << ","
+                  << sol->kinetics()->nReactions() << "," << state.flamespeed << ","
+                  << summary.tau_fast_active << "," << summary.tau_slow_active << ","
+                  << summary.max_stiffness << "," << summary.tau_flame << "," << settings.solver
+                  << "," << settings.initial_chemical_time_step << "," << settings.eps << ","
+                  << settings.c_tau_chem << "," << settings.min_delta_t << ","
+                  << settings.max_delta_t << "\n";
+
+      std::cout << "\n" << name << " (" << sol->thermo()->nSpecies() << " espécies, "
+                << sol->kinetics()->nReactions() << " reações): S_L = " << state.flamespeed
+                << " m/s\n"
+                << "  escala ativa mais rápida = " << summary.tau_fast_active
+                << " s, mais lenta = " << summary.tau_slow_active
+                << " s, rigidez máxima = " << summary.max_stiffness << "\n";
+      if (reference_stiffness > 0.0) {
+        std::cout << "  rigidez " << reference_stiffness / summary.max_stiffness
+                  << "x menor que " << std::filesystem::path(mechanisms.front()).stem().string()
+                  << "\n";
+      } else {
+        reference_stiffness = summary.max_stiffness;
+      }
+      std::cout << "  chemistryProperties: solver " << settings.solver
+                << (settings.solver == "ode" ? " (seulex)" : "")
+                << "; initialChemicalTimeStep " << settings.initial_chemical_time_step
+                << "; odeCoeffs.eps " << settings.eps << "; EulerImplicitCoeffs.cTauChem "
+                << settings.c_tau_chem << "\n"
+                << "  controlDict: deltaT entre " << settings.min_delta_t << " e "
+                << settings.max_delta_t << " s (tau_flame = " << summary.tau_flame << " s)"
+                << std::endl;
+    } catch (std::exception& err) {
+      std::cerr << name << ": " << err.what() << std::endl;
+    }
+  }
+  return 0;
+}
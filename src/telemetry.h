@@ -0,0 +1,181 @@
+#pragma once
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Telemetria de execuções longas (redução, varreduras): contadores globais em std::atomic,
+// atualizados com memory_order_relaxed nos pontos quentes (flamespeed, laço da redução, varredura do
+// main), sem lock e sem alocação. Um servidor HTTP opcional (telemetry_server, só em 127.0.0.1)
+// responde a qualquer GET com um JSON dos valores atuais:
+//
+//   curl -s localhost:8080
+//
+// O tempo de cada solução vai para um histograma de buckets logarítmicos (4 por oitava, a partir de
+// 1 ms), de onde saem a média e o p95 sem guardar as amostras.
+
+struct telemetry_registry {
+  static constexpr size_t n_buckets = 80;  // 1 ms a 2^20 ms (~17 min)
+
+  std::atomic<uint64_t> solves_completed{0};
+  std::atomic<uint64_t> solves_failed{0};  // Exceção do Cantera ou S_L <= 0
+  std::atomic<uint64_t> solve_time_ns{0};  // Soma sobre todas as soluções
+  std::array<std::atomic<uint64_t>, n_buckets> solve_time_buckets{};
+  std::atomic<uint64_t> grid_points_last{0};
+  std::atomic<uint64_t> grid_points_max{0};
+  std::atomic<uint64_t> grid_points_total{0};  // Soma sobre as soluções convergidas
+  std::atomic<int64_t> reduction_depth{-1};    // Reações restantes na redução (-1: fora dela)
+  std::atomic<double> best_error{std::numeric_limits<double>::quiet_NaN()};  // Último aceito
+  std::atomic<int64_t> queue_depth{0};         // Chamas que faltam na varredura atual
+  const std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+  static size_t bucket(double seconds) {
+    double index = 4.0 * std::log2(std::max(seconds * 1e3, 1.0));
+    return std::min(static_cast<size_t>(index), n_buckets - 1);
+  }
+
+  void record_solve(double seconds, bool converged, size_t grid_points) {
+    (converged ? solves_completed : solves_failed).fetch_add(1, std::memory_order_relaxed);
+    solve_time_ns.fetch_add(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+    solve_time_buckets[bucket(seconds)].fetch_add(1, std::memory_order_relaxed);
+    if (converged) {
+      grid_points_last.store(grid_points, std::memory_order_relaxed);
+      grid_points_total.fetch_add(grid_points, std::memory_order_relaxed);
+      auto current = grid_points_max.load(std::memory_order_relaxed);
+      while (current < grid_points &&
+             !grid_points_max.compare_exchange_weak(current, grid_points, std::memory_order_relaxed)) {
+      }
+    }
+  }
+
+  // Quantil q do tempo de solução (s): centro geométrico do bucket que contém o quantil
+  double solve_time_quantile(double q) const {
+    uint64_t total = 0;
+    std::array<uint64_t, n_buckets> counts;
+    for (size_t b = 0; b < n_buckets; b++) {
+      counts[b] = solve_time_buckets[b].load(std::memory_order_relaxed);
+      total += counts[b];
+    }
+    if (total == 0) {
+      return 0.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < n_buckets; b++) {
+      seen += counts[b];
+      if (seen >= rank) {
+        return 1e-3 * std::exp2((static_cast<double>(b) + 0.5) / 4.0);
+      }
+    }
+    return 1e-3 * std::exp2(n_buckets / 4.0);
+  }
+
+  std::string json() const {
+    auto completed = solves_completed.load(std::memory_order_relaxed);
+    auto failed    = solves_failed.load(std::memory_order_relaxed);
+    auto solves    = completed + failed;
+    double uptime  = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    double mean    = solves > 0 ? 1e-9 * solve_time_ns.load(std::memory_order_relaxed) / solves : 0.0;
+    auto queue     = queue_depth.load(std::memory_order_relaxed);
+    double error   = best_error.load(std::memory_order_relaxed);
+
+    std::ostringstream out;
+    out.precision(6);
+    out << "{\"uptime_s\":" << uptime << ",\"solves_completed\":" << completed
+        << ",\"solves_failed\":" << failed
+        << ",\"throughput_per_min\":" << (uptime > 0.0 ? 60.0 * solves / uptime : 0.0)
+        << ",\"solve_time_mean_s\":" << mean << ",\"solve_time_p95_s\":" << solve_time_quantile(0.95)
+        << ",\"grid_points_last\":" << grid_points_last.load(std::memory_order_relaxed)
+        << ",\"grid_points_mean\":"
+        << (completed > 0 ? static_cast<double>(grid_points_total.load(std::memory_order_relaxed)) / completed : 0.0)
+        << ",\"grid_points_max\":" << grid_points_max.load(std::memory_order_relaxed)
+        << ",\"reduction_depth\":" << reduction_depth.load(std::memory_order_relaxed)
+        << ",\"best_error\":";
+    if (std::isfinite(error)) {
+      out << error;
+    } else {
+      out << "null";
+    }
+    out << ",\"queue_depth\":" << queue << ",\"eta_s\":" << static_cast<double>(queue) * mean
+        << "}\n";
+    return out.str();
+  }
+};
+
+telemetry_registry& telemetry() {
+  static telemetry_registry registry;
+  return registry;
+}
+
+// Servidor HTTP mínimo em 127.0.0.1:port, numa thread de fundo; parado no destrutor
+class telemetry_server {
+ public:
+  explicit telemetry_server(int port) {
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) {
+      throw std::runtime_error("telemetry: não foi possível criar o socket");
+    }
+    int reuse = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family      = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port        = htons(static_cast<uint16_t>(port));
+    if (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(fd_, 8) < 0) {
+      ::close(fd_);
+      throw std::runtime_error("telemetry: porta " + std::to_string(port) + " indisponível");
+    }
+    thread_ = std::thread([this]() { serve(); });
+  }
+  ~telemetry_server() {
+    running_ = false;
+    thread_.join();
+    ::close(fd_);
+  }
+  telemetry_server(const telemetry_server&)            = delete;
+  telemetry_server& operator=(const telemetry_server&) = delete;
+
+ private:
+  int fd_ = -1;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+
+  void serve() {
+    while (running_) {
+      pollfd listener{fd_, POLLIN, 0};
+      if (::poll(&listener, 1, 200) <= 0) {
+        continue;
+      }
+      int client = ::accept(fd_, nullptr, nullptr);
+      if (client < 0) {
+        continue;
+      }
+      // Só o começo da requisição interessa; o conteúdo é o mesmo para qualquer caminho
+      pollfd request{client, POLLIN, 0};
+      char buffer[1024];
+      if (::poll(&request, 1, 1000) > 0) {
+        ::recv(client, buffer, sizeof(buffer), 0);
+      }
+      auto body         = telemetry().json();
+      std::string reply = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                          std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+      ::send(client, reply.data(), reply.size(), MSG_NOSIGNAL);
+      ::close(client);
+    }
+  }
+};
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Fila de tarefas em diretório compartilhado, para distribuir uma campanha entre processos (na mesma
+// máquina ou em nós de um cluster com sistema de arquivos comum). Sem dependência do Cantera.
+//
+//   <dir>/pending/<tarefa>          "<tentativa> <especificação>", esperando um worker
+//   <dir>/running/<tarefa>@<worker> reservada; o worker atualiza o mtime (heartbeat)
+//   <dir>/done/<tarefa>             especificação na primeira linha, resultado na segunda
+//   <dir>/failed/<tarefa>           esgotou as tentativas
+//
+// A reserva é um rename de pending/ para running/, atômico no mesmo sistema de arquivos: cada
+// worker pega uma tarefa por vez, então a carga se equilibra sozinha (chamas pobres demoram mais).
+// Tarefas de um worker que morreu (ou cujo heartbeat parou) voltam para pending/ com a tentativa
+// incrementada. Arquivos começando com '.' são temporários e ignorados.
+
+class work_queue {
+ public:
+  struct task {
+    std::string name;
+    std::string spec;
+    int attempt;
+    std::filesystem::path running;
+  };
+
+  int max_attempts = 3;
+
+  explicit work_queue(std::filesystem::path dir) : dir_(std::move(dir)) {
+    for (auto sub : {"pending", "running", "done", "failed"}) {
+      std::filesystem::create_directories(dir_ / sub);
+    }
+  }
+
+  const std::filesystem::path& dir() const { return dir_; }
+
+  // <hostname>-<pid>: único entre os processos de todos os nós
+  static std::string worker_id(pid_t pid = ::getpid()) {
+    char host[256] = {};
+    ::gethostname(host, sizeof(host) - 1);
+    return std::string(host) + "-" + std::to_string(pid);
+  }
+
+  // Ignora tarefas já enfileiradas, em execução ou concluídas (campanha retomada)
+  bool submit(const std::string& name, const std::string& spec) {
+    if (exists(name)) {
+      return false;
+    }
+    write_atomic(dir_ / "pending" / name, "0 " + spec + "\n");
+    return true;
+  }
+
+  std::optional<task> claim(const std::string& worker) {
+    for (const auto& name : list("pending")) {
+      auto pending = dir_ / "pending" / name;
+      auto running = dir_ / "running" / (name + "@" + worker);
+      std::error_code ec;
+      std::filesystem::rename(pending, running, ec);
+      if (ec) {
+        continue;  // Outro worker pegou antes
+      }
+      if (std::filesystem::exists(dir_ / "done" / name)) {
+        std::filesystem::remove(running, ec);  // Reenfileirada depois de concluída
+        continue;
+      }
+      heartbeat(running);
+      auto [attempt, spec] = read_task(running);
+      return task{name, spec, attempt, running};
+    }
+    return std::nullopt;
+  }
+
+  static void heartbeat(const std::filesystem::path& running) {
+    std::error_code ec;
+    std::filesystem::last_write_time(running, std::filesystem::file_time_type::clock::now(), ec);
+  }
+
+  void complete(const task& t, const std::string& result) {
+    write_atomic(dir_ / "done" / t.name, t.spec + "\n" + result + "\n");
+    std::error_code ec;
+    std::filesystem::remove(t.running, ec);
+  }
+
+  // Devolve para pending/ as tarefas do worker (que terminou de forma anormal)
+  size_t requeue_worker(const std::string& worker) {
+    size_t count = 0;
+    for (const auto& entry : list("running")) {
+      auto at = entry.rfind('@');
+      if (at != std::string::npos && entry.substr(at + 1) == worker) {
+        count += requeue(entry);
+      }
+    }
+    return count;
+  }
+
+  // Devolve para pending/ as tarefas sem heartbeat há mais de timeout (worker remoto morto)
+  size_t requeue_stale(std::chrono::seconds timeout) {
+    size_t count = 0;
+    auto now     = std::filesystem::file_time_type::clock::now();
+    for (const auto& entry : list("running")) {
+      std::error_code ec;
+      auto mtime = std::filesystem::last_write_time(dir_ / "running" / entry, ec);
+      if (!ec && now - mtime > timeout) {
+        count += requeue(entry);
+      }
+    }
+    return count;
+  }
+
+  size_t pending() const { return list("pending").size(); }
+  size_t running() const { return list("running").size(); }
+  size_t done() const { return list("done").size(); }
+  size_t failed() const { return list("failed").size(); }
+  bool finished() const { return pending() == 0 && running() == 0; }
+
+  // Resultado de cada tarefa concluída, por nome
+  std::map<std::string, std::string> results() const {
+    std::map<std::string, std::string> results;
+    for (const auto& name : list("done")) {
+      std::ifstream in(dir_ / "done" / name);
+      std::string spec, result;
+      std::getline(in, spec);
+      std::getline(in, result);
+      results[name] = result;
+    }
+    return results;
+  }
+
+  // Especificação das tarefas que esgotaram as tentativas
+  std::map<std::string, std::string> failures() const {
+    std::map<std::string, std::string> failures;
+    for (const auto& name : list("failed")) {
+      failures[name] = read_task(dir_ / "failed" / name).second;
+    }
+    return failures;
+  }
+
+ private:
+  std::filesystem::path dir_;
+
+  std::vector<std::string> list(const std::string& sub) const {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir_ / sub, ec)) {
+      auto name = entry.path().filename().string();
+      if (!name.empty() && name[0] != '.') {
+        names.push_back(name);
+      }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  bool exists(const std::string& name) const {
+    if (std::filesystem::exists(dir_ / "pending" / name) ||
+        std::filesystem::exists(dir_ / "done" / name) ||
+        std::filesystem::exists(dir_ / "failed" / name)) {
+      return true;
+    }
+    for (const auto& entry : list("running")) {
+      if (entry.substr(0, entry.rfind('@')) == name) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static std::pair<int, std::string> read_task(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    int attempt = 0;
+    std::string spec;
+    in >> attempt;
+    in >> std::ws;
+    std::getline(in, spec);
+    return {attempt, spec};
+  }
+
+  static void write_atomic(const std::filesystem::path& path, const std::string& text) {
+    auto temporary = path.parent_path() / ("." + path.filename().string() + "." +
+                                           std::to_string(::getpid()));
+    {
+      std::ofstream out(temporary, std::ios::trunc);
+      out << text;
+    }
+    std::filesystem::rename(temporary, path);
+  }
+
+  // O rename para um temporário em pending/ garante que só um processo reenfileira a tarefa
+  size_t requeue(const std::string& entry) {
+    auto name      = entry.substr(0, entry.rfind('@'));
+    auto temporary = dir_ / "pending" / ("." + entry);
+    std::error_code ec;
+    std::filesystem::rename(dir_ / "running" / entry, temporary, ec);
+    if (ec) {
+      return 0;
+    }
+    auto [attempt, spec] = read_task(temporary);
+    std::filesystem::remove(temporary, ec);
+    if (std::filesystem::exists(dir_ / "done" / name)) {
+      return 0;
+    }
+    attempt++;
+    auto target = attempt >= max_attempts ? dir_ / "failed" / name : dir_ / "pending" / name;
+    write_atomic(target, std::to_string(attempt) + " " + spec + "\n");
+    return 1;
+  }
+};